@@ -0,0 +1,60 @@
+#include "auction.h"
+#include <string.h>
+
+void auction_open(Auction *a, int tile, int seller, SeatMask bidders, int seconds) {
+    a->id++;
+    a->open = 1;
+    a->tile = tile;
+    a->seller = seller;
+    a->bidders = bidders;
+    a->asked = 0;
+    a->answered = 0;
+    memset(a->bids, 0, sizeof(a->bids));
+    clock_gettime(CLOCK_REALTIME, &a->deadline);
+    a->deadline.tv_sec += seconds;
+}
+
+int auction_wants_bid(const Auction *a, int seat) {
+    SeatMask bit = seat_bit(seat);
+    return a->open && (a->bidders & bit) && !(a->asked & bit);
+}
+
+uint32_t auction_begin_bid(Auction *a, int seat) {
+    a->asked |= seat_bit(seat);
+    return a->id;
+}
+
+int auction_submit(Auction *a, uint32_t id, int seat, int bid, int money) {
+    if (!a->open || a->id != id) {
+        return -1;
+    }
+    a->bids[seat] = (bid > 0 && bid <= money) ? bid : 0;
+    a->answered |= seat_bit(seat);
+    return 0;
+}
+
+int auction_settled(const Auction *a) {
+    return (a->answered & a->bidders) == a->bidders;
+}
+
+int auction_close(Auction *a, int *price) {
+    a->open = 0;
+    return auction_best_bid(a, price);
+}
+
+int auction_best_bid(const Auction *a, int *price) {
+    int winner = -1;
+    *price = 0;
+    for (SeatMask seats = a->answered; seats; seats &= seats - 1) {
+        int seat = __builtin_ctzll(seats);
+        if (a->bids[seat] > *price) {
+            *price = a->bids[seat];
+            winner = seat;
+        }
+    }
+    return winner;
+}
+
+void auction_drop_bid(Auction *a, int seat) {
+    a->bids[seat] = 0;
+}
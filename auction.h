@@ -0,0 +1,64 @@
+#ifndef AUCTION_H
+#define AUCTION_H
+
+#include <stdint.h>
+#include <time.h>
+#include "seats.h"
+
+// Sealed-bid auctions for tiles a player passes on.
+// The seller's process opens the auction in shared memory and wakes every
+// bidder; each seat's own process collects its bid (from its socket, or from
+// the bot policy) in parallel, so one deadline bounds the whole auction.
+// Nobody holds game_mutex while waiting for a client: bids are posted
+// with short lock holds and the seller waits on its seat with a timeout.
+
+#define AUCTION_SECONDS 10      // How long humans get to bid
+#define AUCTION_MAX_SEATS 64    // Seat masks are SeatMasks
+#define AUCTION_BID_TAG '$'     // Client sends this byte, then a BidReply
+
+typedef struct {
+    uint32_t id;                // Bumped per auction, so late bids are dropped
+    int open;
+    int tile;
+    int seller;                 // Seat that passed on the tile (runs the auction)
+    struct timespec deadline;   // CLOCK_REALTIME, like wait_seat()'s deadlines
+    SeatMask bidders;           // Seats asked to bid (alive when it opened)
+    SeatMask asked;             // Seats whose process has started collecting
+    SeatMask answered;          // Seats whose bid is in
+    int32_t bids[AUCTION_MAX_SEATS];
+} Auction;
+
+// A client's answer to MSG_AUCTION. The id is echoed back so a bid that
+// arrives after its auction closed can never count for the next one.
+typedef struct {
+    uint32_t auction_id;
+    int32_t amount;             // 0 = pass
+} BidReply;
+
+// Open an auction for `tile` among the seats in `bidders`
+void auction_open(Auction *a, int tile, int seller, SeatMask bidders, int seconds);
+
+// 1 if `seat` should start collecting a bid for the open auction
+int auction_wants_bid(const Auction *a, int seat);
+
+// Claim the seat's bid (so it is only collected once); returns the auction id
+uint32_t auction_begin_bid(Auction *a, int seat);
+
+// Post a sealed bid (0 = pass). Bids above `money` count as a pass.
+// Returns 0, or -1 if auction `id` has already closed.
+int auction_submit(Auction *a, uint32_t id, int seat, int bid, int money);
+
+// 1 once every bidder has answered
+int auction_settled(const Auction *a);
+
+// Close the auction. Returns the winning seat (highest bid, lowest seat on
+// a tie) and stores its bid in *price, or -1 if everybody passed.
+int auction_close(Auction *a, int *price);
+
+// Highest bid still standing, as auction_close() picks it
+int auction_best_bid(const Auction *a, int *price);
+
+// Strike a seat's bid (it can no longer pay), so the next best one stands
+void auction_drop_bid(Auction *a, int seat);
+
+#endif // AUCTION_H
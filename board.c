@@ -0,0 +1,347 @@
+#include "board.h"
+#include "game_state.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *kind_names[TILE_KIND_COUNT] = {
+    [TILE_PROPERTY] = "property",
+    [TILE_GO] = "go",
+    [TILE_TAX] = "tax",
+    [TILE_CHANCE] = "chance",
+    [TILE_COMMUNITY_CHEST] = "chest"
+};
+
+static int parse_kind(const char *word, TileKind *kind) {
+    for (int k = 0; k < TILE_KIND_COUNT; k++) {
+        if (strcmp(word, kind_names[k]) == 0) {
+            *kind = (TileKind)k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// "15" or "15,75,225,..." (up to BOARD_RENT_LEVELS values, rest stay 0)
+static int parse_rents(const char *field, int32_t rent[]) {
+    int level = 0;
+    const char *p = field;
+    while (*p) {
+        char *end;
+        long value = strtol(p, &end, 10);
+        if (end == p || level >= BOARD_RENT_LEVELS || value < 0) {
+            return -1;
+        }
+        rent[level++] = (int32_t)value;
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        p = end;
+    }
+    return level > 0 ? 0 : -1;
+}
+
+static char *trim(char *s) {
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) {
+        *--end = '\0';
+    }
+    return s;
+}
+
+// Fill in the group spans after the last tile. Returns 0, or -1 if a
+// group reaches further than BOARD_GROUP_SPAN tiles from its first.
+static int index_groups(BoardDef *def, const char *path) {
+    GroupSpan *spans = (GroupSpan *)&def->tiles[def->tile_count];
+    memset(spans, 0, ((size_t)def->group_count + 1) * sizeof(GroupSpan));
+    for (uint32_t t = 0; t < def->tile_count; t++) {
+        uint32_t group = def->tiles[t].group;
+        if (group == 0) {
+            continue;
+        }
+        GroupSpan *span = &spans[group];
+        if (span->mask == 0) {
+            span->first = (uint16_t)t;
+        }
+        if (t - span->first >= BOARD_GROUP_SPAN) {
+            fprintf(stderr, "[BOARD] Error: %s: group %u spans more than %d tiles\n",
+                    path, group, BOARD_GROUP_SPAN);
+            return -1;
+        }
+        span->mask |= 1ULL << (t - span->first);
+    }
+    return 0;
+}
+
+// Parse a text definition into a malloc'd blob
+static BoardDef *parse_text(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[BOARD] Error: cannot open %s\n", path);
+        return NULL;
+    }
+
+    BoardDef *def = calloc(1, board_def_size(MAX_BOARD_SIZE, BOARD_MAX_GROUPS));
+    if (def == NULL) {
+        fprintf(stderr, "[BOARD] Error: out of memory\n");
+        fclose(f);
+        return NULL;
+    }
+    def->magic = BOARD_MAGIC;
+    def->version = BOARD_VERSION;
+    def->start_money = START_MONEY;
+
+    char line[256];
+    int line_no = 0;
+    int group_house_price = 0;
+    uint32_t group_first = 0, group_last = 0;   // Ends of the current group's ring (first == last + 1 = empty)
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char *text = trim(line);
+        if (*text == '\0' || *text == '#') {
+            continue;
+        }
+
+        char word[16], rents[64];
+        int price, house_price, used = 0;
+        if (strncmp(text, "name", 4) == 0 && isspace((unsigned char)text[4])) {
+            snprintf(def->name, sizeof(def->name), "%s", trim(text + 4));
+            continue;
+        }
+        if (sscanf(text, "start_money %d", &def->start_money) == 1) {
+            continue;
+        }
+        // group <house_price>: the properties that follow form one color group
+        if (sscanf(text, "group %d", &house_price) == 1) {
+            if (def->group_count >= BOARD_MAX_GROUPS || house_price < 0 || house_price > UINT16_MAX) {
+                fprintf(stderr, "[BOARD] Error: %s:%d: at most %d groups, house price 0-%d\n",
+                        path, line_no, BOARD_MAX_GROUPS, UINT16_MAX);
+                free(def);
+                fclose(f);
+                return NULL;
+            }
+            def->group_count++;
+            group_house_price = house_price;
+            group_first = def->tile_count;
+            group_last = def->tile_count - 1;
+            continue;
+        }
+
+        // <kind> <price> <rent[,rent...]> <name>
+        Property tile;
+        TileKind kind;
+        memset(&tile, 0, sizeof(tile));
+        if (sscanf(text, "%15s %d %63s %n", word, &price, rents, &used) != 3 ||
+            parse_kind(word, &kind) != 0 || parse_rents(rents, tile.rent) != 0 ||
+            price < 0 || text[used] == '\0') {
+            fprintf(stderr, "[BOARD] Error: %s:%d: expected '<kind> <price> <rent[,...]> <name>'\n",
+                    path, line_no);
+            free(def);
+            fclose(f);
+            return NULL;
+        }
+        if (def->tile_count >= MAX_BOARD_SIZE) {
+            fprintf(stderr, "[BOARD] Error: %s: more than %d tiles\n", path, MAX_BOARD_SIZE);
+            free(def);
+            fclose(f);
+            return NULL;
+        }
+        tile.kind = (uint8_t)kind;
+        tile.price = kind == TILE_PROPERTY ? price : 0;
+        tile.group_next = (uint16_t)def->tile_count;
+        if (kind == TILE_PROPERTY && def->group_count > 0) {
+            // Close the ring back to the group's first tile
+            tile.group = (uint16_t)def->group_count;
+            tile.house_price = (uint16_t)group_house_price;
+            if (group_last + 1 != group_first) {
+                def->tiles[group_last].group_next = (uint16_t)def->tile_count;
+                tile.group_next = (uint16_t)group_first;
+            } else {
+                group_first = def->tile_count;
+            }
+            group_last = def->tile_count;
+        }
+        snprintf(tile.name, sizeof(tile.name), "%s", text + used);
+        def->tiles[def->tile_count++] = tile;
+    }
+    fclose(f);
+
+    if (def->tile_count == 0) {
+        fprintf(stderr, "[BOARD] Error: %s defines no tiles\n", path);
+        free(def);
+        return NULL;
+    }
+    if (index_groups(def, path) != 0) {
+        free(def);
+        return NULL;
+    }
+    return def;
+}
+
+static int validate(const BoardDef *def, size_t size, const char *path) {
+    if (size < sizeof(BoardDef) || def->magic != BOARD_MAGIC) {
+        fprintf(stderr, "[BOARD] Error: %s is not a board blob\n", path);
+        return -1;
+    }
+    if (def->version != BOARD_VERSION) {
+        fprintf(stderr, "[BOARD] Error: %s has format version %u (expected %d)\n",
+                path, def->version, BOARD_VERSION);
+        return -1;
+    }
+    if (def->group_count > BOARD_MAX_GROUPS) {
+        fprintf(stderr, "[BOARD] Error: %s has %u groups (at most %d)\n",
+                path, def->group_count, BOARD_MAX_GROUPS);
+        return -1;
+    }
+    if (def->tile_count == 0 || def->tile_count > MAX_BOARD_SIZE ||
+        size != board_def_size(def->tile_count, def->group_count)) {
+        fprintf(stderr, "[BOARD] Error: %s is truncated or has a bad tile count\n", path);
+        return -1;
+    }
+    // Rent updates walk the group rings, so each must hold exactly its group's tiles
+    uint32_t *group_size = calloc(def->group_count + 1, sizeof(uint32_t));
+    if (group_size == NULL) {
+        fprintf(stderr, "[BOARD] Error: out of memory\n");
+        return -1;
+    }
+    int ok = 1;
+    for (uint32_t t = 0; t < def->tile_count && ok; t++) {
+        const Property *tile = &def->tiles[t];
+        if (tile->kind >= TILE_KIND_COUNT) {
+            fprintf(stderr, "[BOARD] Error: %s: tile %u has an unknown kind\n", path, t);
+            ok = 0;
+        } else if (tile->group > def->group_count || tile->group_next >= def->tile_count ||
+                   def->tiles[tile->group_next].group != tile->group ||
+                   (tile->group == 0 && tile->group_next != t)) {
+            fprintf(stderr, "[BOARD] Error: %s: tile %u has a bad group\n", path, t);
+            ok = 0;
+        } else {
+            group_size[tile->group]++;
+        }
+    }
+    // Ownership checks use the spans, so each must hold exactly its group's tiles
+    for (uint32_t t = 0; t < def->tile_count && ok; t++) {
+        const GroupSpan *span = board_group_span(def, def->tiles[t].group);
+        uint32_t offset = t - span->first;
+        if (def->tiles[t].group != 0 &&
+            (t < span->first || offset >= BOARD_GROUP_SPAN || !((span->mask >> offset) & 1))) {
+            fprintf(stderr, "[BOARD] Error: %s: tile %u is missing from its group's span\n", path, t);
+            ok = 0;
+        }
+    }
+    for (uint32_t g = 1; g <= def->group_count && ok; g++) {
+        if ((uint32_t)__builtin_popcountll(board_group_span(def, g)->mask) != group_size[g]) {
+            fprintf(stderr, "[BOARD] Error: %s: group %u has a bad span\n", path, g);
+            ok = 0;
+        }
+    }
+    for (uint32_t t = 0; t < def->tile_count && ok; t++) {
+        uint32_t group = def->tiles[t].group;
+        uint32_t steps = 0;
+        uint32_t at = t;
+        do {
+            at = def->tiles[at].group_next;
+            steps++;
+        } while (at != t && steps < group_size[group]);
+        if (group != 0 && (at != t || steps != group_size[group])) {
+            fprintf(stderr, "[BOARD] Error: %s: group %u has bad tiles\n", path, group);
+            ok = 0;
+        }
+    }
+    free(group_size);
+    return ok ? 0 : -1;
+}
+
+int board_compile(const char *text_path, const char *blob_path) {
+    BoardDef *def = parse_text(text_path);
+    if (def == NULL) {
+        return -1;
+    }
+
+    // Write then rename, so a running server never maps a half-written blob
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", blob_path);
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        fprintf(stderr, "[BOARD] Error: cannot create %s\n", tmp_path);
+        free(def);
+        return -1;
+    }
+
+    size_t size = board_def_size(def->tile_count, def->group_count);
+    int ok = fwrite(def, 1, size, f) == size;
+    ok = (fclose(f) == 0) && ok;
+    free(def);
+
+    if (!ok || rename(tmp_path, blob_path) != 0) {
+        fprintf(stderr, "[BOARD] Error: cannot write %s\n", blob_path);
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+const BoardDef *board_load(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "[BOARD] Error: cannot open %s\n", path);
+        return NULL;
+    }
+
+    struct stat st;
+    uint32_t magic = 0;
+    if (fstat(fd, &st) == -1 || pread(fd, &magic, sizeof(magic), 0) < 0) {
+        fprintf(stderr, "[BOARD] Error: cannot read %s\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    if (magic == BOARD_MAGIC) {
+        // Compiled blob: map the file itself, pages come from the page cache
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            fprintf(stderr, "[BOARD] Error: cannot map %s\n", path);
+            return NULL;
+        }
+        if (validate((const BoardDef *)map, (size_t)st.st_size, path) != 0) {
+            munmap(map, (size_t)st.st_size);
+            return NULL;
+        }
+        return (const BoardDef *)map;
+    }
+    close(fd);
+
+    // Text: compile into a shared anonymous mapping, then seal it read-only
+    BoardDef *def = parse_text(path);
+    if (def == NULL) {
+        return NULL;
+    }
+    size_t size = board_def_size(def->tile_count, def->group_count);
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[BOARD] Error: cannot map board for %s\n", path);
+        free(def);
+        return NULL;
+    }
+    memcpy(map, def, size);
+    free(def);
+    mprotect(map, size, PROT_READ);
+    return (const BoardDef *)map;
+}
+
+void board_close(const BoardDef *board) {
+    if (board != NULL) {
+        munmap((void *)board, board_def_size(board->tile_count, board->group_count));
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Board definitions: tile kinds, prices, rent tables and names.
+// Authored as text (see boards/*.board), compiled by monopoly_boardc into
+// a flat binary blob that is mmap'd read-only. One loaded BoardDef is
+// shared by every room (and every forked child) playing that board;
+// rooms only keep the per-tile state that changes during a game.
+
+#define MAX_BOARD_SIZE 4096       // Tile numbers are 16 bits wide everywhere they are stored
+#define BOARD_RENT_LEVELS 6       // Base rent, 1-4 houses, hotel
+#define BOARD_HOTEL (BOARD_RENT_LEVELS - 1)
+#define BOARD_MAX_GROUPS MAX_BOARD_SIZE   // Color groups per board (tile group 0 = none)
+#define BOARD_MAGIC 0x4452424du   // "MBRD"
+#define BOARD_VERSION 4
+#define BOARD_GROUP_SPAN 64       // A group's tiles lie within this many tiles of its first
+#define DEFAULT_BOARD_FILE "boards/malaysia.mbd"
+
+// Tile kinds (decide which landing handler runs)
+typedef enum {
+    TILE_PROPERTY,
+    TILE_GO,
+    TILE_TAX,
+    TILE_CHANCE,
+    TILE_COMMUNITY_CHEST,
+    TILE_KIND_COUNT
+} TileKind;
+
+// Property structure (one per board tile, read-only once loaded)
+typedef struct {
+    char name[28];
+    uint8_t kind;                     // TileKind
+    uint8_t reserved;
+    uint16_t group;                   // Color group 1..BOARD_MAX_GROUPS, 0 = none
+    uint16_t group_next;              // Next tile of the group's ring (itself if no group)
+    uint16_t house_price;             // Cost of one building level, 0 = cannot build
+    int32_t price;                    // 0 for tiles that cannot be bought
+    int32_t rent[BOARD_RENT_LEVELS];  // Rent by level; rent[0] is the tax due on tax tiles
+} Property;
+
+// One color group as a mask over the tiles from its first: bit i set =
+// tile first + i belongs to the group
+typedef struct {
+    uint16_t first;
+    uint16_t reserved[3];
+    uint64_t mask;
+} GroupSpan;
+
+// Binary blob layout: this header, tile_count tiles, then group_count + 1
+// group spans indexed by group number (span 0, "no group", is empty)
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t tile_count;
+    int32_t start_money;
+    char name[32];
+    uint32_t group_count;
+    uint8_t reserved[76];
+    Property tiles[];
+} BoardDef;
+
+_Static_assert(sizeof(Property) == 64, "board tiles are one cache line in the blob");
+_Static_assert(sizeof(BoardDef) == 128, "board header is two cache lines in the blob");
+_Static_assert(sizeof(GroupSpan) == 16, "group spans pack four to a cache line");
+_Static_assert(MAX_BOARD_SIZE <= UINT16_MAX, "tile numbers are stored in 16 bits");
+
+// Each color group is a ring threaded through group_next, so walking a
+// group costs its size rather than the board's:
+//     int t = tile;
+//     do { ... } while ((t = board_group_next(board, t)) != tile);
+// A tile with no group is a ring of one.
+static inline int board_group_next(const BoardDef *board, int tile) {
+    return board->tiles[tile].group_next;
+}
+
+// Membership of a whole group at once, for ownership checks against a
+// seat's tile bitboard
+static inline const GroupSpan *board_group_span(const BoardDef *board, int group) {
+    return (const GroupSpan *)&board->tiles[board->tile_count] + group;
+}
+
+static inline size_t board_def_size(uint32_t tile_count, uint32_t group_count) {
+    return sizeof(BoardDef) + (size_t)tile_count * sizeof(Property) +
+           ((size_t)group_count + 1) * sizeof(GroupSpan);
+}
+
+// Compile a text definition into a binary blob. Returns 0, or -1 on error.
+int board_compile(const char *text_path, const char *blob_path);
+
+// Load a board (binary blob, or text compiled on the fly) into a read-only
+// shared mapping. Map it before forking so children share the pages.
+// Returns NULL on error.
+const BoardDef *board_load(const char *path);
+
+// Unmap a board returned by board_load
+void board_close(const BoardDef *board);
+
+#endif // BOARD_H
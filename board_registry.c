@@ -0,0 +1,276 @@
+#include "board_registry.h"
+#include "logger.h"
+#include "instance.h"
+#include "sync.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Per-process cache of mapped versions. Threads of one process share it
+// (the server's estimator maps boards while the accept loop does), so it
+// has its own lock, and a mapping is only dropped once its version has
+// been reclaimed and nobody in this process still uses it.
+typedef struct {
+    uint32_t version;
+    int refs;                       // board_registry_map() calls not yet released
+    size_t size;
+    const BoardDef *def;
+} MappedVersion;
+
+static MappedVersion mapped[BOARD_REGISTRY_SLOTS];
+static pthread_mutex_t mapped_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t mapped_once = PTHREAD_ONCE_INIT;
+
+// A fork must not catch another thread holding mapped_lock, and the
+// child only starts with the caller's thread: references held by the
+// others did not come along
+static void mapped_prepare(void) {
+    pthread_mutex_lock(&mapped_lock);
+}
+
+static void mapped_parent(void) {
+    pthread_mutex_unlock(&mapped_lock);
+}
+
+static void mapped_child(void) {
+    for (int i = 0; i < BOARD_REGISTRY_SLOTS; i++) {
+        mapped[i].refs = 0;
+    }
+    pthread_mutex_unlock(&mapped_lock);
+}
+
+static void mapped_init(void) {
+    pthread_atfork(mapped_prepare, mapped_parent, mapped_child);
+}
+
+static void segment_name(char *name, size_t len, uint32_t version) {
+    char base[32];
+    snprintf(base, sizeof(base), BOARD_SEGMENT_FORMAT, version);
+    instance_ipc_name(name, len, base);
+}
+
+static BoardVersion *find_slot(BoardRegistry *reg, uint32_t version) {
+    for (int i = 0; i < BOARD_REGISTRY_SLOTS; i++) {
+        if (reg->slots[i].version == version) {
+            return &reg->slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Caller holds reg->lock
+static void reclaim(BoardVersion *slot) {
+    char name[64];
+    segment_name(name, sizeof(name), slot->version);
+    shm_unlink(name);
+    logger_log("Board version %u (%s) reclaimed", slot->version, slot->source);
+    memset(slot, 0, sizeof(BoardVersion));
+}
+
+BoardRegistry *board_registry_init(void *mem) {
+    if (mem == NULL) {
+        return NULL;
+    }
+    BoardRegistry *reg = mem;
+    memset(reg, 0, sizeof(BoardRegistry));
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&reg->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    reg->next_version = 1;
+    return reg;
+}
+
+void board_registry_destroy(BoardRegistry *reg) {
+    if (reg == NULL) {
+        return;
+    }
+    char name[64];
+    for (int i = 0; i < BOARD_REGISTRY_SLOTS; i++) {
+        if (reg->slots[i].version != 0) {
+            segment_name(name, sizeof(name), reg->slots[i].version);
+            shm_unlink(name);
+        }
+    }
+    pthread_mutex_destroy(&reg->lock);
+}
+
+// Copy a loaded board into a new segment that other processes map by name
+static int write_segment(uint32_t version, const BoardDef *def) {
+    char name[64];
+    size_t size = board_def_size(def->tile_count, def->group_count);
+    segment_name(name, sizeof(name), version);
+
+    // Version numbers restart with the server; drop a crashed run's leftover
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0444);
+    if (fd == -1) {
+        perror("[BOARDS] shm_open");
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)size) == -1) {
+        perror("[BOARDS] ftruncate");
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("[BOARDS] mmap");
+        shm_unlink(name);
+        return -1;
+    }
+    memcpy(map, def, size);
+    munmap(map, size);
+    return 0;
+}
+
+uint32_t board_registry_publish(BoardRegistry *reg, const char *path) {
+    const BoardDef *def = board_load(path);
+    if (def == NULL) {
+        return 0;
+    }
+
+    sync_mutex_lock(&reg->lock);
+    BoardVersion *slot = find_slot(reg, 0);
+    if (slot == NULL) {
+        pthread_mutex_unlock(&reg->lock);
+        board_close(def);
+        fprintf(stderr, "[BOARDS] Error: %d versions still in use, cannot publish %s\n",
+                BOARD_REGISTRY_SLOTS, path);
+        return 0;
+    }
+
+    uint32_t version = reg->next_version;
+    if (write_segment(version, def) != 0) {
+        pthread_mutex_unlock(&reg->lock);
+        board_close(def);
+        return 0;
+    }
+    reg->next_version++;
+    slot->version = version;
+    slot->pins = 0;
+    slot->size = (uint32_t)board_def_size(def->tile_count, def->group_count);
+    snprintf(slot->source, sizeof(slot->source), "%s", path);
+
+    // The swap: rooms created from now on get the new version
+    uint32_t old = reg->current;
+    __atomic_store_n(&reg->current, version, __ATOMIC_RELEASE);
+
+    BoardVersion *old_slot = old != 0 ? find_slot(reg, old) : NULL;
+    if (old_slot != NULL && old_slot->pins == 0) {
+        reclaim(old_slot);
+    }
+    pthread_mutex_unlock(&reg->lock);
+
+    logger_log("Board version %u published: %s from %s (%u tiles)",
+               version, def->name, path, def->tile_count);
+    board_close(def);
+    return version;
+}
+
+uint32_t board_registry_current(const BoardRegistry *reg) {
+    return __atomic_load_n(&reg->current, __ATOMIC_ACQUIRE);
+}
+
+uint32_t board_registry_pin(BoardRegistry *reg) {
+    sync_mutex_lock(&reg->lock);
+    uint32_t version = reg->current;
+    BoardVersion *slot = version != 0 ? find_slot(reg, version) : NULL;
+    if (slot != NULL) {
+        slot->pins++;
+    }
+    pthread_mutex_unlock(&reg->lock);
+    return slot != NULL ? version : 0;
+}
+
+void board_registry_unpin(BoardRegistry *reg, uint32_t version) {
+    sync_mutex_lock(&reg->lock);
+    BoardVersion *slot = version != 0 ? find_slot(reg, version) : NULL;
+    if (slot != NULL && --slot->pins <= 0 && version != reg->current) {
+        reclaim(slot);
+    }
+    pthread_mutex_unlock(&reg->lock);
+}
+
+const BoardDef *board_registry_map(BoardRegistry *reg, uint32_t version) {
+    pthread_once(&mapped_once, mapped_init);
+    pthread_mutex_lock(&mapped_lock);
+    for (int i = 0; i < BOARD_REGISTRY_SLOTS; i++) {
+        if (mapped[i].version == version && version != 0) {
+            mapped[i].refs++;
+            pthread_mutex_unlock(&mapped_lock);
+            return mapped[i].def;
+        }
+    }
+
+    // Drop mappings of versions that have since been reclaimed, unless a
+    // thread of this process is still reading them
+    MappedVersion *free_entry = NULL;
+    sync_mutex_lock(&reg->lock);
+    for (int i = 0; i < BOARD_REGISTRY_SLOTS; i++) {
+        MappedVersion *m = &mapped[i];
+        if (m->version != 0 && m->refs == 0 && find_slot(reg, m->version) == NULL) {
+            munmap((void *)m->def, m->size);
+            memset(m, 0, sizeof(MappedVersion));
+        }
+        if (m->version == 0 && free_entry == NULL) {
+            free_entry = m;
+        }
+    }
+    pthread_mutex_unlock(&reg->lock);
+    if (free_entry == NULL) {
+        pthread_mutex_unlock(&mapped_lock);
+        fprintf(stderr, "[BOARDS] Error: too many board versions mapped\n");
+        return NULL;
+    }
+
+    char name[64];
+    segment_name(name, sizeof(name), version);
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1) {
+        pthread_mutex_unlock(&mapped_lock);
+        fprintf(stderr, "[BOARDS] Error: board version %u is not available\n", version);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(BoardDef)) {
+        pthread_mutex_unlock(&mapped_lock);
+        close(fd);
+        return NULL;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        pthread_mutex_unlock(&mapped_lock);
+        perror("[BOARDS] mmap");
+        return NULL;
+    }
+
+    free_entry->version = version;
+    free_entry->refs = 1;
+    free_entry->size = (size_t)st.st_size;
+    free_entry->def = (const BoardDef *)map;
+    pthread_mutex_unlock(&mapped_lock);
+    return (const BoardDef *)map;
+}
+
+void board_registry_release(const BoardDef *board) {
+    if (board == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&mapped_lock);
+    for (int i = 0; i < BOARD_REGISTRY_SLOTS; i++) {
+        if (mapped[i].def == board && mapped[i].refs > 0) {
+            mapped[i].refs--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mapped_lock);
+}
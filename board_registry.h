@@ -0,0 +1,69 @@
+#ifndef BOARD_REGISTRY_H
+#define BOARD_REGISTRY_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "board.h"
+
+// Versioned boards in shared memory, for hot reload without a restart.
+//
+// The registry itself lives in the room's shared memory segment. Every
+// published board version is copied into its own shared memory segment, which any process (including children forked earlier) can map
+// read-only by version number. Publishing swaps `current` RCU-style: the
+// new version is fully written before it becomes visible, and readers
+// never lock to use a version they hold.
+//
+// A room pins the current version when its game starts and keeps playing
+// that version until it unpins at game over, however many versions are
+// published meanwhile. A version that is no longer current is reclaimed
+// (its segment unlinked) when its last pin drops.
+
+#define BOARD_SEGMENT_FORMAT "board_v%u"    // Per instance, see instance_ipc_name()
+#define BOARD_REGISTRY_SLOTS 8      // Live versions at once (current + pinned)
+
+typedef struct {
+    uint32_t version;               // 0 = free slot
+    int32_t pins;                   // Rooms playing this version
+    uint32_t size;                  // Blob size in bytes
+    char source[128];               // File the version was loaded from
+} BoardVersion;
+
+typedef struct {
+    pthread_mutex_t lock;           // Publish, pin, unpin and reclaim (process-shared)
+    uint32_t current;               // Version new rooms pin (atomic)
+    uint32_t next_version;
+    BoardVersion slots[BOARD_REGISTRY_SLOTS];
+} BoardRegistry;
+
+// Set up an empty registry in zeroed shared memory (server parent, before
+// forking; the room segment carries it). Returns `mem`.
+BoardRegistry *board_registry_init(void *mem);
+
+// Unlink every version segment (the registry's own memory is the caller's)
+void board_registry_destroy(BoardRegistry *reg);
+
+// Load a board file and make it the current version.
+// Returns the new version number, or 0 on failure (current is unchanged).
+uint32_t board_registry_publish(BoardRegistry *reg, const char *path);
+
+// Version new rooms would get right now (lock-free)
+uint32_t board_registry_current(const BoardRegistry *reg);
+
+// Pin the current version for a room; returns it (0 if nothing published)
+uint32_t board_registry_pin(BoardRegistry *reg);
+
+// Drop a room's pin. The version is reclaimed if it was the last pin and
+// a newer version has been published.
+void board_registry_unpin(BoardRegistry *reg, uint32_t version);
+
+// Map a version read-only in this process and take a local reference on
+// the mapping (cached per process; safe to call from several threads).
+// The caller must hold a pin on the version. A reclaimed version stays
+// mapped until the last local reference is released. Returns NULL if it
+// cannot be mapped.
+const BoardDef *board_registry_map(BoardRegistry *reg, uint32_t version);
+
+// Drop a local reference taken by board_registry_map (NULL is ignored)
+void board_registry_release(const BoardDef *board);
+
+#endif // BOARD_REGISTRY_H
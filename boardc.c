@@ -0,0 +1,34 @@
+#include <stdio.h>
+#include "board.h"
+
+/**
+ * Board compiler
+ *
+ * Turns a text board definition (boards/<name>.board) into the binary blob the
+ * server and tools mmap at startup:
+ *
+ *   ./monopoly_boardc boards/malaysia.board boards/malaysia.mbd
+ *
+ * The output is written to a temporary file and renamed into place, so it
+ * is safe to recompile a board that a running server is using.
+ */
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <board.txt> <board.mbd>\n", argv[0]);
+        return 1;
+    }
+
+    if (board_compile(argv[1], argv[2]) != 0) {
+        return 1;
+    }
+
+    const BoardDef *board = board_load(argv[2]);
+    if (board == NULL) {
+        return 1;
+    }
+    printf("[BOARDC] %s: board '%s', %u tiles, %u groups, start money $%d\n",
+           argv[2], board->name, board->tile_count, board->group_count, board->start_money);
+    board_close(board);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "cards.h"
+#include <stdlib.h>
+
+static const Card chance_cards[] = {
+    {CARD_MOVE_TO, 0, "Advance to Go"},
+    {CARD_MOVE_TO, 15, "Advance to KLCC"},
+    {CARD_MOVE_TO, 8, "Take a trip to Langkawi"},
+    {CARD_MOVE_BY, -3, "Go back 3 spaces"},
+    {CARD_MOVE_BY, 2, "Move forward 2 spaces"},
+    {CARD_MONEY, -30, "Speeding fine: pay $30"},
+    {CARD_MONEY, -25, "Chairman of the board: pay $25"},
+    {CARD_MONEY, 50, "Bank pays you a dividend of $50"},
+    {CARD_MONEY, 80, "You won a crossword competition: collect $80"},
+    {CARD_COLLECT_FROM_ALL, 20, "Open house: collect $20 from every player"}
+};
+
+static const Card community_chest_cards[] = {
+    {CARD_MONEY, 150, "Bank error in your favour: collect $150"},
+    {CARD_MONEY, 140, "Inheritance: collect $140"},
+    {CARD_MONEY, 120, "Holiday fund matures: collect $120"},
+    {CARD_MONEY, 100, "Income tax refund: collect $100"},
+    {CARD_MONEY, -50, "Doctor's fee: pay $50"},
+    {CARD_MONEY, -60, "Car repairs: pay $60"},
+    {CARD_MONEY, -75, "School fees: pay $75"},
+    {CARD_MONEY, -90, "Hospital fees: pay $90"},
+    {CARD_MOVE_TO, 0, "Advance to Go"},
+    {CARD_COLLECT_FROM_ALL, 25, "It is your birthday: collect $25 from every player"}
+};
+
+static const struct {
+    const Card *cards;
+    int count;
+} decks[DECK_COUNT] = {
+    [DECK_CHANCE] = {chance_cards, sizeof(chance_cards) / sizeof(Card)},
+    [DECK_COMMUNITY_CHEST] = {community_chest_cards, sizeof(community_chest_cards) / sizeof(Card)}
+};
+
+_Static_assert(sizeof(chance_cards) / sizeof(Card) <= DECK_MAX_CARDS, "too many Chance cards");
+_Static_assert(sizeof(community_chest_cards) / sizeof(Card) <= DECK_MAX_CARDS,
+               "too many Community Chest cards");
+
+static inline int card_at(uint64_t order, int slot) {
+    return (int)((order >> (slot * 4)) & 0xF);
+}
+
+// Fisher-Yates shuffle of card indices into the 4-bit order array
+static void shuffle(CardDeck *deck) {
+    uint8_t cards[DECK_MAX_CARDS];
+    unsigned int seed = deck->seed;
+
+    for (int i = 0; i < deck->count; i++) {
+        cards[i] = (uint8_t)i;
+    }
+    for (int i = deck->count - 1; i > 0; i--) {
+        int j = rand_r(&seed) % (i + 1);
+        uint8_t tmp = cards[i];
+        cards[i] = cards[j];
+        cards[j] = tmp;
+    }
+
+    deck->order = 0;
+    for (int i = 0; i < deck->count; i++) {
+        deck->order |= (uint64_t)cards[i] << (i * 4);
+    }
+    deck->seed = seed;
+    deck->next = 0;
+}
+
+void deck_init(CardDeck *deck, DeckId id, unsigned int seed) {
+    deck->count = (uint8_t)decks[id].count;
+    deck->seed = seed;
+    shuffle(deck);
+}
+
+const Card *deck_draw(CardDeck *deck, DeckId id) {
+    if (deck->next >= deck->count) {
+        shuffle(deck);
+    }
+    return &decks[id].cards[card_at(deck->order, deck->next++)];
+}
+
+void deck_shuffle_remaining(CardDeck *deck, unsigned int seed) {
+    for (int i = deck->count - 1; i > deck->next; i--) {
+        int j = deck->next + rand_r(&seed) % (i - deck->next + 1);
+        uint64_t a = (uint64_t)card_at(deck->order, i);
+        uint64_t b = (uint64_t)card_at(deck->order, j);
+        deck->order &= ~((0xFULL << (i * 4)) | (0xFULL << (j * 4)));
+        deck->order |= (a << (j * 4)) | (b << (i * 4));
+    }
+}
+
+const Card *deck_card(DeckId id, int index) {
+    if (index < 0 || index >= decks[id].count) {
+        return NULL;
+    }
+    return &decks[id].cards[index];
+}
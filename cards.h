@@ -0,0 +1,54 @@
+#ifndef CARDS_H
+#define CARDS_H
+
+#include <stdint.h>
+
+// Chance and Community Chest card decks.
+// Each room keeps one CardDeck per deck kind: a Fisher-Yates shuffled
+// order of card indices drawn front to back and reshuffled when empty.
+// Shuffles only use the deck's own seed, so a recorded seed reproduces
+// every draw exactly in simulations and replays.
+
+#define DECK_MAX_CARDS 16   // order holds 4 bits per card
+
+typedef enum {
+    DECK_CHANCE,
+    DECK_COMMUNITY_CHEST,
+    DECK_COUNT
+} DeckId;
+
+typedef enum {
+    CARD_MONEY,             // Receive (amount > 0) or pay (amount < 0)
+    CARD_MOVE_TO,           // Move to tile `amount`, then resolve that tile
+    CARD_MOVE_BY,           // Move `amount` tiles (may be negative), then resolve
+    CARD_COLLECT_FROM_ALL   // Every other player still in the game pays `amount`
+} CardEffect;
+
+typedef struct {
+    CardEffect effect;
+    int amount;
+    const char *text;
+} Card;
+
+// Compact deck state (16 bytes) so it can live in shared memory and in
+// PackedGameState alike
+typedef struct {
+    uint64_t order;         // 4-bit card indices, next card at bits [4*next, 4*next+3]
+    uint32_t seed;          // rand_r state for the next reshuffle
+    uint8_t count;          // Cards in the deck
+    uint8_t next;           // Index of the next card to draw
+} CardDeck;
+
+// Shuffle a fresh deck from a seed
+void deck_init(CardDeck *deck, DeckId id, unsigned int seed);
+
+// Draw the next card (O(1); reshuffles when the deck runs out)
+const Card *deck_draw(CardDeck *deck, DeckId id);
+
+// Shuffle only the cards not yet drawn (a player's view of the deck)
+void deck_shuffle_remaining(CardDeck *deck, unsigned int seed);
+
+// Look up a card by deck and index (for formatting recorded draws)
+const Card *deck_card(DeckId id, int index);
+
+#endif // CARDS_H
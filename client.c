@@ -2,21 +2,80 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include "game_state.h"
+#include "trade.h"
+#include "instance.h"
 
 #define SERVER_IP "127.0.0.1"
-#define SERVER_PORT 8080
+
+// Parse "1,3,5" (tile numbers) into a trade tile list; "-" means none.
+// Tiles past TRADE_MAX_TILES are dropped.
+static void parse_tile_list(const char *text, uint16_t tiles[TRADE_MAX_TILES]) {
+    int count = 0;
+    for (int i = 0; i < TRADE_MAX_TILES; i++) {
+        tiles[i] = TILE_NONE;
+    }
+    while (*text && count < TRADE_MAX_TILES) {
+        char *end;
+        long tile = strtol(text, &end, 10);
+        if (end == text) {
+            break;
+        }
+        if (tile >= 0 && tile < MAX_BOARD_SIZE) {
+            tiles[count++] = (uint16_t)tile;
+        }
+        text = *end == ',' ? end + 1 : end;
+    }
+}
+
+// Ask for the terms of a trade and send it (after the action byte)
+static int send_trade(int sock) {
+    TradeOffer offer;
+    char give[128], take[128];
+    memset(&offer, 0, sizeof(offer));
+    
+    printf("Trade with player #: ");
+    if (scanf("%d", &offer.to) != 1) {
+        return -1;
+    }
+    printf("Cash you pay (negative = you receive): ");
+    if (scanf("%d", &offer.cash) != 1) {
+        return -1;
+    }
+    printf("Tiles you give (e.g. 1,3 or -, at most %d): ", TRADE_MAX_TILES);
+    if (scanf("%127s", give) != 1) {
+        return -1;
+    }
+    printf("Tiles you want (e.g. 5 or -): ");
+    if (scanf("%127s", take) != 1) {
+        return -1;
+    }
+    parse_tile_list(give, offer.give);
+    parse_tile_list(take, offer.take);
+    return write(sock, &offer, sizeof(offer)) == sizeof(offer) ? 0 : -1;
+}
 
 int main(int argc, char *argv[]) {
     int sock = 0;
     struct sockaddr_in serv_addr;
     Packet pkt;
 
-    (void)argc;
-    (void)argv;
+    // Connect to the server of instance -i (or $MONOPOLY_INSTANCE)
+    int c;
+    const char *instance = NULL;
+    while ((c = getopt(argc, argv, "i:")) != -1) {
+        switch (c) {
+            case 'i': instance = optarg; break;
+            default: fprintf(stderr, "Usage: %s [-i instance]\n", argv[0]); return 1;
+        }
+    }
+    if (instance_init(instance) != 0) {
+        return 1;
+    }
 
     // Create socket
     if ((sock = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
@@ -25,7 +84,7 @@ int main(int argc, char *argv[]) {
     }
 
     serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port = htons(SERVER_PORT);
+    serv_addr.sin_port = htons(instance_port());
 
     // Convert IP address
     if (inet_pton(AF_INET, SERVER_IP, &serv_addr.sin_addr) <= 0) {
@@ -62,7 +121,7 @@ int main(int argc, char *argv[]) {
                 printf("Position: %d | Money: $%d\n", pkt.position, pkt.money);
                 printf("%s\n", pkt.message);
                 printf("========================================\n");
-                printf("Press 'r' and Enter to roll dice: ");
+                printf("Press 'r' (roll), 'b' (build, then roll) or 't' (trade) and Enter: ");
                 
                 char input;
                 if (scanf(" %c", &input) != 1) {
@@ -70,12 +129,60 @@ int main(int argc, char *argv[]) {
                     close(sock);
                     return 1;
                 }
-                if (write(sock, &input, 1) < 0) {
+                if (write(sock, &input, 1) < 0 || (input == TRADE_TAG && send_trade(sock) != 0)) {
+                    perror("write");
+                    close(sock);
+                    return 1;
+                }
+                break;
+
+            case MSG_AUCTION: {
+                printf("\n[AUCTION] %s\n", pkt.message);
+                printf("Money: $%d | Your bid: ", pkt.money);
+                fflush(stdout);
+                
+                // Always answer, with a pass if the deadline runs out first
+                BidReply reply = { pkt.reply_id, 0 };
+                struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+                if (poll(&pfd, 1, AUCTION_SECONDS * 1000) > 0) {
+                    if (scanf("%d", &reply.amount) != 1) {
+                        reply.amount = 0;
+                        scanf("%*s");
+                    }
+                } else {
+                    printf("(too late, passing)\n");
+                }
+                char tag = AUCTION_BID_TAG;
+                if (write(sock, &tag, 1) < 0 || write(sock, &reply, sizeof(reply)) < 0) {
+                    perror("write");
+                    close(sock);
+                    return 1;
+                }
+                break;
+            }
+
+            case MSG_TRADE: {
+                printf("\n[TRADE] %s\n", pkt.message);
+                printf("Money: $%d | Accept (y/n): ", pkt.money);
+                fflush(stdout);
+                
+                // Always answer, with a refusal if the deadline runs out first
+                TradeReply reply = { pkt.reply_id, 0 };
+                struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+                char answer;
+                if (poll(&pfd, 1, TRADE_SECONDS * 1000) > 0 && scanf(" %c", &answer) == 1) {
+                    reply.accept = answer == 'y' || answer == 'Y';
+                } else {
+                    printf("(too late, refusing)\n");
+                }
+                char tag = TRADE_REPLY_TAG;
+                if (write(sock, &tag, 1) < 0 || write(sock, &reply, sizeof(reply)) < 0) {
                     perror("write");
                     close(sock);
                     return 1;
                 }
                 break;
+            }
 
             case MSG_UPDATE:
                 printf("\n[UPDATE] %s\n", pkt.message);
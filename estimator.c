@@ -0,0 +1,300 @@
+#include "estimator.h"
+#include "logger.h"
+#include "simulation.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ESTIMATOR_POLL_US 10000          // How often the watcher looks for a new turn
+#define ESTIMATOR_BATCH 200              // Rollouts per task per batch
+#define ESTIMATOR_MAX_ROLLOUTS 20000     // Stop refining a position after this many
+#define ESTIMATOR_PRIOR_ROLLOUTS 400     // Weight of the previous turn's estimate
+
+typedef struct {
+    WinEstimator *est;
+    GameState *room;
+    const SimGame *start;
+    const BotPolicy *const *policies;
+    long move;                           // Position this task belongs to
+    unsigned int seed;
+    double wins[PACKED_MAX_SEATS];
+    int rollouts;
+} RolloutTask;
+
+// Watcher-owned scratch space, reused for every room in turn
+typedef struct {
+    RolloutTask *tasks;
+    SimGame *start;
+    const BotPolicy *policies[PACKED_MAX_SEATS];
+    unsigned int seed;
+} Batch;
+
+static long current_move(const GameState *room) {
+    return __atomic_load_n(&room->move_count, __ATOMIC_ACQUIRE);
+}
+
+static void rollout_task(void *arg) {
+    RolloutTask *task = (RolloutTask *)arg;
+    SimGame game = *task->start;
+
+    memset(task->wins, 0, sizeof(task->wins));
+    task->rollouts = 0;
+
+    for (int i = 0; i < ESTIMATOR_BATCH; i++) {
+        // Abandon the batch as soon as the room moves on
+        if (current_move(task->room) != task->move) {
+            break;
+        }
+
+        sim_reset(&game, &task->start->state);
+        game.seed = task->seed + (unsigned int)i * 2654435761u;
+        sim_redeal_cards(&game);
+        int winner = sim_playout(&game, task->policies, SIM_MAX_TURNS);
+
+        if (winner >= 0) {
+            task->wins[winner] += 1.0;
+        } else {
+            // Unfinished game: split the point between the survivors
+            uint8_t alive = game.state.active_mask & ~game.state.bankrupt_mask;
+            int count = __builtin_popcount(alive);
+            for (int p = 0; p < game.state.num_players; p++) {
+                if ((alive >> p) & 1) {
+                    task->wins[p] += 1.0 / count;
+                }
+            }
+        }
+        task->rollouts++;
+    }
+
+    WinEstimator *est = task->est;
+    pthread_mutex_lock(&est->batch_lock);
+    if (--est->batch_pending == 0) {
+        pthread_cond_signal(&est->batch_done);
+    }
+    pthread_mutex_unlock(&est->batch_lock);
+}
+
+// Copy the live position without the mutex (seqlock read, never delays a
+// commit). On success the board stays mapped for the batch; release it
+// with board_registry_release(game->board).
+static int take_snapshot(WinEstimator *est, GameState *room, SimGame *game, long *move) {
+    GameState *copy = &est->snapshot;
+    game_state_snapshot(room, copy);
+    const BoardDef *board = copy->game_state == PLAYING
+                                ? board_registry_map(est->boards, copy->board_version) : NULL;
+    *move = copy->move_count;
+    if (board == NULL || sim_init(game, copy, board, (unsigned int)time(NULL)) != 0) {
+        board_registry_release(board);
+        return -1;
+    }
+    return 0;
+}
+
+static void publish(GameState *room, const RoomEstimate *re) {
+    for (int p = 0; p < re->players; p++) {
+        room->win_pct[p] = (int)lround(100.0 * re->wins[p] / re->total);
+    }
+    __atomic_store_n(&room->win_pct_move, re->move, __ATOMIC_RELEASE);
+}
+
+static void log_estimate(const RoomEstimate *re) {
+    char line[128];
+    int len = 0;
+    for (int p = 0; p < re->players && len < (int)sizeof(line); p++) {
+        len += snprintf(line + len, sizeof(line) - len, " P%d=%.0f%%", p,
+                        100.0 * re->wins[p] / re->total);
+    }
+    logger_log("Win probability in room %u after move %ld:%s (%.0f rollouts)",
+               re->handle.index, re->move, line, re->total);
+}
+
+// Move a room's totals on to a new position, seeded with the last
+// estimate as pseudo-rollouts
+static void begin_position(RoomEstimate *re, long move, int players) {
+    // Finish off the previous position in the log before moving on
+    if (!re->logged && re->total > ESTIMATOR_PRIOR_ROLLOUTS) {
+        log_estimate(re);
+    }
+
+    if (re->total > 0.0 && players == re->players) {
+        for (int p = 0; p < players; p++) {
+            re->wins[p] = re->wins[p] / re->total * ESTIMATOR_PRIOR_ROLLOUTS;
+        }
+        re->total = ESTIMATOR_PRIOR_ROLLOUTS;
+    } else {
+        memset(re->wins, 0, sizeof(re->wins));
+        re->total = 0.0;
+    }
+    re->players = players;
+    re->move = move;
+    re->logged = 0;
+}
+
+// Run one batch for a room the watcher holds a reference on. Returns 1 if
+// any rollouts were queued, 0 if the room had nothing to do.
+static int estimate_room(WinEstimator *est, GameState *room, RoomHandle handle, Batch *batch) {
+    RoomEstimate *re = &est->rooms[handle.index];
+    if (re->handle.generation != handle.generation || re->handle.index != handle.index) {
+        // A new room in this slot
+        memset(re, 0, sizeof(RoomEstimate));
+        re->handle = handle;
+        re->move = -1;
+        re->logged = 1;
+    }
+
+    if (__atomic_load_n(&room->game_state, __ATOMIC_ACQUIRE) != PLAYING) {
+        return 0;
+    }
+    if (current_move(room) == re->move &&
+        re->total >= ESTIMATOR_MAX_ROLLOUTS + ESTIMATOR_PRIOR_ROLLOUTS) {
+        if (!re->logged) {
+            log_estimate(re);
+            re->logged = 1;
+        }
+        return 0;
+    }
+
+    long move;
+    if (take_snapshot(est, room, batch->start, &move) != 0) {
+        return 0;
+    }
+    if (move != re->move) {
+        begin_position(re, move, batch->start->state.num_players);
+    }
+
+    // One batch spread over every pool worker. A full queue means the pool
+    // is behind: the task is skipped rather than run on this thread.
+    int threads = est->pool->num_threads;
+    int queued = 0;
+    est->batch_pending = threads;
+    for (int i = 0; i < threads; i++) {
+        RolloutTask *task = &batch->tasks[i];
+        task->est = est;
+        task->room = room;
+        task->start = batch->start;
+        task->policies = batch->policies;
+        task->move = move;
+        task->seed = rand_r(&batch->seed);
+        memset(task->wins, 0, sizeof(task->wins));
+        task->rollouts = 0;
+        if (pool_submit(est->pool, rollout_task, task) == 0) {
+            queued++;
+        }
+    }
+
+    pthread_mutex_lock(&est->batch_lock);
+    est->batch_pending -= threads - queued;
+    while (est->batch_pending > 0) {
+        pthread_cond_wait(&est->batch_done, &est->batch_lock);
+    }
+    pthread_mutex_unlock(&est->batch_lock);
+    board_registry_release(batch->start->board);
+
+    if (queued == 0 || current_move(room) != move) {
+        return queued > 0;   // Deferred, or stale: the next turn was committed meanwhile
+    }
+
+    for (int i = 0; i < threads; i++) {
+        for (int p = 0; p < re->players; p++) {
+            re->wins[p] += batch->tasks[i].wins[p];
+        }
+        re->total += batch->tasks[i].rollouts;
+    }
+    if (re->total > 0.0) {
+        publish(room, re);
+    }
+    return 1;
+}
+
+static void *watcher_main(void *arg) {
+    WinEstimator *est = (WinEstimator *)arg;
+    Batch batch;
+    BotPolicy policy;
+
+    batch.tasks = calloc((size_t)est->pool->num_threads, sizeof(RolloutTask));
+    batch.start = malloc(sizeof(SimGame));
+    batch.seed = (unsigned int)time(NULL);
+    if (batch.tasks == NULL || batch.start == NULL) {
+        fprintf(stderr, "[ESTIMATOR] Error: out of memory\n");
+        free(batch.tasks);
+        free(batch.start);
+        return NULL;
+    }
+
+    bot_policy_default(&policy);
+    for (int p = 0; p < PACKED_MAX_SEATS; p++) {
+        batch.policies[p] = &policy;
+    }
+
+    while (est->running) {
+        // Every live room in turn, one batch each; a reference keeps the
+        // slot from being reused while its room is being estimated
+        int busy = 0;
+        for (int i = 0; i < ROOM_SLOTS && est->running; i++) {
+            RoomHandle handle;
+            GameState *room = room_ref_at(i, &handle);
+            if (!room) {
+                continue;
+            }
+            busy |= estimate_room(est, room, handle, &batch);
+            room_unref(room);
+        }
+        if (!busy) {
+            usleep(ESTIMATOR_POLL_US);
+        }
+    }
+
+    free(batch.tasks);
+    free(batch.start);
+    return NULL;
+}
+
+WinEstimator *estimator_start(BoardRegistry *boards, ThreadPool *pool) {
+    if (boards == NULL || pool == NULL) {
+        fprintf(stderr, "[ESTIMATOR] Error: boards and pool are required\n");
+        return NULL;
+    }
+
+    WinEstimator *est = calloc(1, sizeof(WinEstimator));
+    if (est == NULL) {
+        fprintf(stderr, "[ESTIMATOR] Error: out of memory\n");
+        return NULL;
+    }
+
+    est->boards = boards;
+    est->pool = pool;
+    est->running = 1;
+    for (int i = 0; i < ROOM_SLOTS; i++) {
+        est->rooms[i].handle = ROOM_NONE;
+    }
+    pthread_mutex_init(&est->batch_lock, NULL);
+    pthread_cond_init(&est->batch_done, NULL);
+
+    int result = pthread_create(&est->watcher, NULL, watcher_main, est);
+    if (result != 0) {
+        fprintf(stderr, "[ESTIMATOR] Error: pthread_create failed: %s\n", strerror(result));
+        pthread_mutex_destroy(&est->batch_lock);
+        pthread_cond_destroy(&est->batch_done);
+        free(est);
+        return NULL;
+    }
+
+    printf("[ESTIMATOR] Watching %d room slots (pool: %d low-priority threads)\n",
+           ROOM_SLOTS, pool->num_threads);
+    return est;
+}
+
+void estimator_stop(WinEstimator *est) {
+    if (est == NULL) {
+        return;
+    }
+
+    est->running = 0;
+    pthread_join(est->watcher, NULL);
+    pthread_mutex_destroy(&est->batch_lock);
+    pthread_cond_destroy(&est->batch_done);
+    free(est);
+}
@@ -0,0 +1,69 @@
+#ifndef ESTIMATOR_H
+#define ESTIMATOR_H
+
+#include <pthread.h>
+#include "board_registry.h"
+#include "game_state.h"
+#include "packed_state.h"
+#include "thread_pool.h"
+
+/**
+ * Win-Probability Estimator Header
+ *
+ * Watches every live room of the slab and, after every committed turn,
+ * estimates each seat's chance of winning by playing random games forward
+ * from the current position on a low-priority thread pool. Rooms take
+ * turns, one batch each, so a busy table cannot starve the others.
+ *
+ * The estimate is refined batch by batch and published into the room's
+ * shared memory (win_pct[], win_pct_move) where spectators and monitors can
+ * read it; the final figure for each position also goes to the game log.
+ * The previous position's estimate seeds the next one, so a fresh turn
+ * starts from a sensible value instead of from zero.
+ *
+ * The watcher never takes game_mutex (it copies the position with
+ * game_state_snapshot) and holds a room reference while it works on a
+ * room. Stale batches are abandoned as soon as the next turn is committed,
+ * and rollouts the pool has no room for are skipped, never run on the
+ * watcher thread.
+ */
+
+// Per-slot progress: the room being estimated and its running totals
+typedef struct {
+    RoomHandle handle;
+    long move;
+    int players;
+    double wins[PACKED_MAX_SEATS];
+    double total;
+    int logged;
+} RoomEstimate;
+
+typedef struct {
+    BoardRegistry *boards;       // Where the rooms' pinned board versions live
+    ThreadPool *pool;            // Low-priority pool
+    pthread_t watcher;
+    volatile int running;
+    GameState snapshot;          // Watcher's private copy of the position
+    RoomEstimate rooms[ROOM_SLOTS];
+
+    // Batch completion
+    pthread_mutex_t batch_lock;
+    pthread_cond_t batch_done;
+    int batch_pending;
+} WinEstimator;
+
+/**
+ * Start estimating the slab's rooms in a background watcher thread
+ *
+ * @param boards Board registry the rooms pin their versions from
+ * @param pool Pool created with pool_create(n, 1)
+ * @return Estimator, or NULL on failure
+ */
+WinEstimator *estimator_start(BoardRegistry *boards, ThreadPool *pool);
+
+/**
+ * Stop the watcher, wait for in-flight rollouts and free the estimator
+ */
+void estimator_stop(WinEstimator *est);
+
+#endif // ESTIMATOR_H
@@ -13,71 +13,230 @@ int is_player_bankrupt(int money) {
     return money < 0;
 }
 
-// Handle landing on a position - returns what happened
-LandingResult handle_landing_on_position(int position, int player_id, int current_money,
-                                          Property board[], unsigned int *seed) {
-    LandingResult result;
-    memset(&result, 0, sizeof(LandingResult));
-    result.money_change = 0;
-    result.owner_id = -1;
-    result.property_bought = 0;
-    result.is_bankrupt = 0;
+// GO: nothing to pay or collect
+static void land_on_go(const LandingContext *ctx, LandingResult *result) {
+    (void)ctx;
+    result->event = LAND_NOTHING;
+}
+
+// TAX tiles: pay the tile's amount
+static void land_on_tax(const LandingContext *ctx, LandingResult *result) {
+    result->event = LAND_TAX;
+    result->money_change = -ctx->tile->rent[0];
+}
+
+// Finish a card that moved the player: resolve the destination tile.
+// Only one level deep - a card tile reached this way does not draw again.
+static void land_after_card(const LandingContext *ctx, int target, LandingResult *result) {
+    LandingContext next = *ctx;
+    next.position = target;
+    next.tile = &ctx->board->tiles[target];
+    next.owner = ctx->owners[target];
+    result->new_position = (uint16_t)target;
     
-    // TAX OFFICE (position 10): Pay $50 tax
-    if (position == 10) {
-        result.money_change = -50;
-        sprintf(result.message, "TAX OFFICE! You paid $50 in taxes");
+    TileKind kind = next.tile->kind;
+    if (kind == TILE_CHANCE || kind == TILE_COMMUNITY_CHEST) {
+        land_on_go(&next, result);
+    } else {
+        ctx->handlers[target](&next, result);
     }
-    // COMMUNITY CHEST (positions 2, 17): Random card draw
-    else if (position == 2 || position == 17) {
-        int card = rand_r(seed) % 2;  // Random card effect
-        if (card == 0) {
-            // Good luck card - get money
-            int bonus = 100 + (rand_r(seed) % 50);
-            result.money_change = bonus;
-            sprintf(result.message, "Community Chest! You drew a LUCKY card: +$%d!", bonus);
-        } else {
-            // Bad luck card - pay money
-            int penalty = 50 + (rand_r(seed) % 50);
-            result.money_change = -penalty;
-            sprintf(result.message, "Community Chest! You drew a BAD card: -$%d!", penalty);
-        }
+}
+
+// Draw the next card of a deck and apply its effect
+static void draw_card(const LandingContext *ctx, DeckId deck, LandingResult *result) {
+    const Card *card = deck_draw(&ctx->decks[deck], deck);
+    int size = (int)ctx->board->tile_count;
+    result->card_tile = (uint16_t)ctx->position;
+    result->card = (uint8_t)(card - deck_card(deck, 0));
+    
+    switch (card->effect) {
+        case CARD_MONEY:
+            result->event = LAND_CARD;
+            result->money_change = card->amount;
+            break;
+        case CARD_MOVE_TO:
+            land_after_card(ctx, card->amount % size, result);
+            break;
+        case CARD_MOVE_BY:
+            land_after_card(ctx, ((ctx->position + card->amount) % size + size) % size, result);
+            break;
+        case CARD_COLLECT_FROM_ALL:
+            // Payers are only known to the commit step
+            result->event = LAND_CARD;
+            result->collect_amount = card->amount;
+            break;
     }
-    // NORMAL PROPERTY
-    else {
-        Property *prop = &board[position];
-        
-        if (prop->owner == -1) {
-            // Unowned - buy if can afford
-            if (current_money >= prop->price) {
-                result.money_change = -prop->price;
-                result.property_bought = 1;
-                sprintf(result.message, "Bought %s for $%d", prop->name, prop->price);
-            } else {
-                sprintf(result.message, "Can't afford %s ($%d needed)", prop->name, prop->price);
-            }
-        } else if (prop->owner != player_id) {
-            // Pay rent
-            int rent = prop->rent;
-            result.money_change = -rent;
-            result.owner_id = prop->owner;
-            sprintf(result.message, "Paid $%d rent to Player %d on %s", rent, prop->owner, prop->name);
+}
+
+// CHANCE: draw from the Chance deck
+static void land_on_chance(const LandingContext *ctx, LandingResult *result) {
+    draw_card(ctx, DECK_CHANCE, result);
+}
+
+// COMMUNITY CHEST: draw from the Community Chest deck
+static void land_on_community_chest(const LandingContext *ctx, LandingResult *result) {
+    draw_card(ctx, DECK_COMMUNITY_CHEST, result);
+}
+
+// NORMAL PROPERTY: buy if unowned, pay rent if someone else owns it
+static void land_on_property(const LandingContext *ctx, LandingResult *result) {
+    const Property *prop = ctx->tile;
+    
+    if (ctx->owner == -1) {
+        // Unowned - buy if can afford
+        if (ctx->current_money >= prop->price) {
+            result->event = LAND_BOUGHT;
+            result->money_change = -prop->price;
+            result->property_bought = 1;
         } else {
-            sprintf(result.message, "Landed on own property %s", prop->name);
+            result->event = LAND_CANT_AFFORD;
+            result->for_auction = 1;
         }
+    } else if (ctx->owner != ctx->player_id) {
+        // Pay rent (kept current by ownership and building events)
+        result->event = LAND_RENT;
+        result->money_change = -ctx->rents[ctx->position];
+        result->owner_id = (int8_t)ctx->owner;
+    } else {
+        result->event = LAND_OWN;
     }
+}
+
+static const TileHandler kind_handlers[TILE_KIND_COUNT] = {
+    [TILE_PROPERTY] = land_on_property,
+    [TILE_GO] = land_on_go,
+    [TILE_TAX] = land_on_tax,
+    [TILE_CHANCE] = land_on_chance,
+    [TILE_COMMUNITY_CHEST] = land_on_community_chest
+};
+
+// Build the dispatch table for a board (once per board)
+void build_tile_dispatch(TileDispatch *dispatch, const BoardDef *board) {
+    dispatch->board = board;
+    for (uint32_t i = 0; i < board->tile_count; i++) {
+        TileKind kind = board->tiles[i].kind;
+        dispatch->handler[i] = (kind >= 0 && kind < TILE_KIND_COUNT)
+                                   ? kind_handlers[kind] : land_on_property;
+    }
+}
+
+// Handle landing on a position - returns what happened
+LandingResult handle_landing_on_position(const TileDispatch *dispatch, int position,
+                                          int player_id, int current_money,
+                                          const int owners[], const int rents[],
+                                          CardDeck decks[]) {
+    LandingResult result;
+    memset(&result, 0, sizeof(LandingResult));
+    result.owner_id = -1;
+    result.new_position = (uint16_t)position;
+    result.card_tile = LANDING_NO_CARD;
+    
+    const BoardDef *board = dispatch->board;
+    LandingContext ctx = { position, player_id, current_money, &board->tiles[position],
+                           owners[position], board, owners, rents, dispatch->handler, decks };
+    dispatch->handler[position](&ctx, &result);
     
     // Check if player would go bankrupt
     int new_money = current_money + result.money_change;
     if (is_player_bankrupt(new_money)) {
         result.is_bankrupt = 1;
-        strcat(result.message, " - BANKRUPT!");
     }
     
     return result;
 }
-<<<<<<< HEAD
 
+// Turn a purchase into a pass (player declines to buy the tile)
+void decline_purchase(LandingResult *result) {
+    if (!result->property_bought) {
+        return;
+    }
+    result->event = LAND_PASSED;
+    result->money_change = 0;
+    result->property_bought = 0;
+    result->for_auction = 1;
+}
+
+// Describe what happened on the tile itself
+static void format_event(const BoardDef *board, const LandingResult *result, char *out, size_t size) {
+    const Property *tile = &board->tiles[result->new_position];
+    switch ((LandingEvent)result->event) {
+        case LAND_NOTHING:
+            snprintf(out, size, "Landed on %s", tile->name);
+            break;
+        case LAND_TAX:
+            snprintf(out, size, "%s! You paid $%d in taxes", tile->name, -result->money_change);
+            break;
+        case LAND_BOUGHT:
+            snprintf(out, size, "Bought %s for $%d", tile->name, tile->price);
+            break;
+        case LAND_CANT_AFFORD:
+            snprintf(out, size, "Can't afford %s ($%d needed)", tile->name, tile->price);
+            break;
+        case LAND_PASSED:
+            snprintf(out, size, "Passed on %s ($%d)", tile->name, tile->price);
+            break;
+        case LAND_RENT:
+            snprintf(out, size, "Paid $%d rent to Player %d on %s", -result->money_change,
+                     result->owner_id, tile->name);
+            break;
+        case LAND_OWN:
+            snprintf(out, size, "Landed on own property %s", tile->name);
+            break;
+        case LAND_CARD:
+            out[0] = '\0';     // The card text says it all
+            break;
+    }
+}
+
+// Describe a landing for a person
+void format_landing(const BoardDef *board, const LandingResult *result, char *out, size_t size) {
+    char event[128];
+    format_event(board, result, event, sizeof(event));
+    
+    const char *bankrupt = result->is_bankrupt ? " - BANKRUPT!" : "";
+    if (result->card_tile == LANDING_NO_CARD) {
+        snprintf(out, size, "%s%s", event, bankrupt);
+        return;
+    }
+    
+    const Property *card_tile = &board->tiles[result->card_tile];
+    DeckId deck = card_tile->kind == TILE_CHANCE ? DECK_CHANCE : DECK_COMMUNITY_CHEST;
+    const Card *card = deck_card(deck, result->card);
+    snprintf(out, size, "%s! %s%s%s%s", card_tile->name, card ? card->text : "?",
+             result->event == LAND_CARD ? "" : " -> ", event, bankrupt);
+}
+
+// Rent due on a tile at a building level (monopoly doubles an unbuilt tile's rent)
+int tile_rent(const Property *tile, int level, int monopoly) {
+    if (level > 0) {
+        return tile->rent[level];
+    }
+    return monopoly ? tile->rent[0] * 2 : tile->rent[0];
+}
 
-=======
->>>>>>> 9eab809df4a66e2b6187c91dbcb000bddc2d27ae
+// Refresh the rents of one color group (ungrouped tiles are their own group)
+void update_group_rents(const BoardDef *board, int tile, const int owners[],
+                        const uint8_t buildings[], int rents[]) {
+    int owner = owners[tile];
+    
+    int monopoly = board->tiles[tile].group != 0 && owner >= 0;
+    for (int t = board_group_next(board, tile); t != tile && monopoly; t = board_group_next(board, t)) {
+        monopoly = owners[t] == owner;
+    }
+    
+    int t = tile;
+    do {
+        rents[t] = owners[t] < 0 ? 0 : tile_rent(&board->tiles[t], buildings[t], monopoly);
+    } while ((t = board_group_next(board, t)) != tile);
+}
+
+// Fill rents[] for a whole board, once per group: rings are threaded in
+// tile order, so only a group's last tile links back to a lower one
+void build_rent_table(const BoardDef *board, const int owners[],
+                      const uint8_t buildings[], int rents[]) {
+    for (int t = 0; t < (int)board->tile_count; t++) {
+        if (board_group_next(board, t) <= t) {
+            update_group_rents(board, t, owners, buildings, rents);
+        }
+    }
+}
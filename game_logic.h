@@ -4,24 +4,97 @@
 // Need type definitions from game_state header
 #include "game_state.h"
 
-// Result of a landing event
+// What happened on the tile the player ended on
+typedef enum {
+    LAND_NOTHING,           // Go, or a card tile reached by another card
+    LAND_TAX,
+    LAND_BOUGHT,
+    LAND_CANT_AFFORD,       // Unowned and too dear: goes to auction
+    LAND_PASSED,            // Unowned and declined: goes to auction
+    LAND_RENT,
+    LAND_OWN,
+    LAND_CARD               // Money or collect-from-all card (player stays put)
+} LandingEvent;
+
+#define LANDING_NO_CARD 0xffff
+
+// Result of a landing event: a compact typed record, turned into text by
+// format_landing() only where a person reads it
 typedef struct {
-    char message[256];
-    int money_change;
-    int owner_id;           // For rent: who gets paid
-    int property_bought;    // 1 if property was bought
-    int is_bankrupt;        // 1 if player went bankrupt
+    int32_t money_change;
+    int32_t collect_amount;     // Paid to the player by every other player still in
+    uint16_t new_position;      // Where the player ends up (cards may move them on)
+    uint16_t card_tile;         // Tile a card was drawn on, LANDING_NO_CARD if none
+    uint8_t event;              // LandingEvent on new_position
+    uint8_t card;               // Card index in the deck of card_tile's kind
+    int8_t owner_id;            // For rent: who gets paid
+    uint8_t property_bought : 1;    // 1 if property was bought
+    uint8_t is_bankrupt : 1;        // 1 if player went bankrupt
+    uint8_t for_auction : 1;        // 1 if an unowned tile was passed on and goes to auction
 } LandingResult;
 
+_Static_assert(sizeof(LandingResult) == 16, "landing results are copied through every simulated turn");
+_Static_assert(MAX_BOARD_SIZE < LANDING_NO_CARD, "tile numbers must fit in 16 bits");
+_Static_assert(MAX_PLAYERS <= 127, "owner_id is a signed byte");
+
+typedef struct LandingContext LandingContext;
+
+// Resolves a landing on one kind of tile
+typedef void (*TileHandler)(const LandingContext *ctx, LandingResult *result);
+
+// Everything a tile handler needs to resolve a landing
+struct LandingContext {
+    int position;
+    int player_id;
+    int current_money;
+    const Property *tile;
+    int owner;                      // Tile's owner, -1 = unowned
+    const BoardDef *board;
+    const int *owners;              // Room's owner per tile (for cards that move the player)
+    const int *rents;               // Room's precomputed rent per tile (same)
+    const TileHandler *handlers;    // Board's jump table (same)
+    CardDeck *decks;                // Room's Chance / Community Chest decks
+};
+
+// Per-board jump table: one handler per tile, chosen by tile kind.
+// Process-local (holds code pointers), so build it after attaching.
+typedef struct {
+    const BoardDef *board;
+    TileHandler handler[MAX_BOARD_SIZE];
+} TileDispatch;
+
 // Roll a dice (1 to 6) with seed
 int roll_dice_seeded(unsigned int *seed);
 
+// Build the dispatch table for a board (once per board)
+void build_tile_dispatch(TileDispatch *dispatch, const BoardDef *board);
+
 // Handle landing on a position - returns what happened
-LandingResult handle_landing_on_position(int position, int player_id, int current_money, 
-                                          Property board[], unsigned int *seed);
+LandingResult handle_landing_on_position(const TileDispatch *dispatch, int position,
+                                          int player_id, int current_money,
+                                          const int owners[], const int rents[],
+                                          CardDeck decks[]);
+
+// Describe a landing for a person ("Paid $25 rent to Player 1 on KLCC")
+void format_landing(const BoardDef *board, const LandingResult *result, char *out, size_t size);
 
 // Check if player is bankrupt
 int is_player_bankrupt(int money);
 
+// Rent due on a tile at a building level (monopoly doubles an unbuilt tile's rent)
+int tile_rent(const Property *tile, int level, int monopoly);
+
+// Refresh rents[] for the color group of `tile` after its owner or buildings
+// changed. Landings only read rents[], they never recompute it.
+void update_group_rents(const BoardDef *board, int tile, const int owners[],
+                        const uint8_t buildings[], int rents[]);
+
+// Fill rents[] for a whole board (when owners[] was rebuilt wholesale)
+void build_rent_table(const BoardDef *board, const int owners[],
+                      const uint8_t buildings[], int rents[]);
+
+// Turn a purchase into a pass (player declines to buy the tile)
+void decline_purchase(LandingResult *result);
+
 
 #endif
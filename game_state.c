@@ -1,204 +1,990 @@
 #include "game_state.h"
+#include "game_logic.h"
 #include "shared_memory.h"
 #include "logger.h"
+#include "instance.h"
+#include "sync.h"
+#include <errno.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
 
-// Initializes GameState within the SharedData structure
-GameState* init_game_state_memory(void) {
-    // Call shared_memory.c's init_shared_memory function
-    if (init_shared_memory(SHM_NAME, sizeof(SharedData)) != 0) {
-        logger_log("Failed to initialize shared memory");
+// The room segment: the slab of room slots and the board registry, mapped
+// with one attach
+enum { ROOM_PART_SLAB, ROOM_PART_BOARDS, ROOM_PART_COUNT };
+
+// Commit journal of a file-backed room: the last two commits of the seqlock
+// range, written alternately at state_write_end(). A restart after a crash
+// mid-commit (seq left odd, or pages torn on the way to disk) goes back to
+// the newest whole commit instead of resuming a half-applied turn.
+// Only the used part of the range is written: see state_spans().
+#define ROOM_JOURNAL_BYTES (offsetof(GameState, auction) - offsetof(GameState, game_state))
+
+typedef struct {
+    uint32_t seq;               // Commit held here (0 = being rewritten), stored last
+    uint32_t sum;               // FNV-1a of data[0..bytes)
+    uint32_t bytes;
+    char data[ROOM_JOURNAL_BYTES];
+} __attribute__((aligned(64))) JournalSlot;
+
+// The part of the seqlock range a board of board_size tiles uses: the
+// fixed fields, then each per-tile array up to board_size. Snapshots and
+// the journal copy just these, so a small board on a table built for
+// thousands of tiles costs what it uses.
+#define STATE_SPANS 4
+
+typedef struct {
+    size_t offset;
+    size_t size;
+} StateSpan;
+
+static void state_spans(int board_size, StateSpan spans[STATE_SPANS]) {
+    size_t tiles = board_size < 0 ? 0 : board_size > MAX_BOARD_SIZE ? MAX_BOARD_SIZE : (size_t)board_size;
+    spans[0] = (StateSpan){ offsetof(GameState, game_state),
+                            offsetof(GameState, buildings) - offsetof(GameState, game_state) };
+    spans[1] = (StateSpan){ offsetof(GameState, buildings), tiles * sizeof(uint8_t) };
+    spans[2] = (StateSpan){ offsetof(GameState, board_owner), tiles * sizeof(int) };
+    spans[3] = (StateSpan){ offsetof(GameState, tile_rent), tiles * sizeof(int) };
+}
+
+// One room: its GameState (locks included) and the slot bookkeeping. The
+// state comes first, so a GameState pointer into the slab is its slot's.
+typedef struct {
+    GameState state;
+    uint32_t generation;        // Bumped on every free; handles carry it
+    uint32_t next_free;         // Free list link (ROOM_SLOTS = end)
+    int32_t refs;               // Processes using the room; 0 = free
+    JournalSlot journal[2];     // Written only when the slab is file-backed
+} __attribute__((aligned(64))) RoomSlot;
+
+// Server-wide scores, shared by every room
+typedef struct {
+    pthread_mutex_t lock __attribute__((aligned(64)));
+    PlayerScore scores[MAX_PLAYERS];
+    int total_games;
+} ScoreBoard;
+
+// Free slots form a stack threaded through next_free. The head packs the
+// top index (low half) with a tag bumped by every pop and push, so a
+// compare-and-swap racing a pop/push pair of the same slot fails (ABA).
+typedef struct {
+    uint64_t free_head __attribute__((aligned(64)));
+    uint32_t rooms_open;
+    ScoreBoard scores;
+    RoomSlot slots[ROOM_SLOTS];
+} RoomSlab;
+
+#define FREE_HEAD(index, tag) ((uint64_t)(tag) << 32 | (uint32_t)(index))
+
+// Layout tags: catch fields that moved without changing the type's size
+#define GAME_STATE_LAYOUT ((uint32_t)(offsetof(GameState, players) ^ offsetof(GameState, board_owner) << 8 ^ \
+                                      offsetof(GameState, decks) << 16 ^ offsetof(GameState, win_pct) << 20 ^ \
+                                      MAX_PLAYERS << 24))
+#define ROOM_SLAB_LAYOUT ((uint32_t)(GAME_STATE_LAYOUT ^ offsetof(RoomSlot, journal) << 4 ^ \
+                                     ROOM_JOURNAL_BYTES << 12 ^ ROOM_SLOTS << 24))
+#define BOARD_REGISTRY_LAYOUT ((uint32_t)(offsetof(BoardRegistry, current) ^ offsetof(BoardRegistry, slots) << 8))
+
+static const SegmentPart room_parts[ROOM_PART_COUNT] = {
+    [ROOM_PART_SLAB] = SEGMENT_PART(RoomSlab, ROOM_SLAB_LAYOUT),
+    [ROOM_PART_BOARDS] = SEGMENT_PART(BoardRegistry, BOARD_REGISTRY_LAYOUT)
+};
+
+static Segment room_segment;    // This process's mapping
+static RoomSlab *slab;          // Inherited by children along with the mapping
+static int journaling;          // Set when the slab is file-backed
+static char room_file[256];     // Backing file ("" = /dev/shm segment)
+
+// This instance's room segment and scores file names
+static const char *room_shm_name(void) {
+    static char name[64];
+    if (name[0] == '\0') {
+        instance_ipc_name(name, sizeof(name), SHM_BASE_NAME);
+    }
+    return name;
+}
+
+static const char *scores_file(void) {
+    static char name[64];
+    if (name[0] == '\0') {
+        instance_file_name(name, sizeof(name), SCORES_FILE);
+    }
+    return name;
+}
+
+// Slot a room lives in, or NULL for a GameState outside the slab (the
+// replayer's and tuner's private copies)
+static RoomSlot *slot_of(const GameState *state) {
+    if (slab == NULL || (const char *)state < (const char *)slab->slots ||
+        (const char *)state >= (const char *)(slab->slots + ROOM_SLOTS)) {
         return NULL;
     }
-    
-    // Now initialize GameState fields on top of the shared memory
-    GameState *state = (GameState *)shared_mem_ptr;
-    
-    // Initialize process-shared synchronization primitives
+    return (RoomSlot *)state;
+}
+
+// Process-shared locks and wakeups. Also redone on a warm restart: the
+// previous server's locks mean nothing to the new one.
+static void init_room_sync(GameState *state) {
     pthread_mutexattr_t mutex_attr;
     pthread_mutexattr_init(&mutex_attr);
     pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);  // A killed child must not wedge the room
     pthread_mutex_init(&state->game_mutex, &mutex_attr);
-    pthread_mutex_init(&state->score_mutex, &mutex_attr);
+    pthread_mutex_init(&state->trade_mutex, &mutex_attr);
     pthread_mutexattr_destroy(&mutex_attr);
     
     // Initialize process-shared condition variable
     pthread_condattr_t cond_attr;
     pthread_condattr_init(&cond_attr);
     pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
-    pthread_cond_init(&state->turn_cond, &cond_attr);
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        pthread_cond_init(&state->seat_wake[i].cond, &cond_attr);
+    }
     pthread_condattr_destroy(&cond_attr);
     
     // Initialize semaphore for logging
     sem_init(&state->log_sem, 1, 1);  // 1 = process-shared
-    
-    // Initialize game state
+    state->write_depth = 0;
+    state->lock_owner = -1;
+}
+
+// The seat_wake conditions are left alone: seats may still be asleep on
+// them at shutdown (or have died there), and pthread_cond_destroy() waits
+// for every waiter to wake. The segment goes away with them regardless.
+static void destroy_room_sync(GameState *state) {
+    pthread_mutex_destroy(&state->game_mutex);
+    pthread_mutex_destroy(&state->trade_mutex);
+    sem_destroy(&state->log_sem);
+}
+
+// Empty table waiting for players
+void reset_game_state(GameState *state) {
+    state_write_begin(state);
     state->game_state = WAITING;
     state->num_players = 0;
-    state->active_player_count = 0;
+    state->alive_mask = 0;
     state->current_turn = 0;
     state->round = 0;
-    state->total_games = 0;
-    
-    // Initialize board
-    init_board(state);
+    state->move_count = 0;
+    state->board_version = 0;
+    state->win_pct_move = -1;
+    memset(state->players, 0, sizeof(state->players));
+    memset(&state->auction, 0, sizeof(state->auction));
+    memset(state->asset_version, 0, sizeof(state->asset_version));
+    state->trade_pending = 0;
+    state->trade_seq = 0;
+    state->replay_path[0] = '\0';
+    state->bot_mask = 0;
+    state->vacant_mask = 0;
+    for (int i = 0; i < MAX_BOARD_SIZE; i++) {
+        state->board_owner[i] = -1;
+    }
+    index_owners(state);
     
-    // Initialize player scores
+    // Shuffle the card decks (reseeded when a game starts)
+    init_decks(state, (unsigned int)time(NULL) ^ (unsigned int)getpid());
+    state_write_end(state);
+    logger_log("Card decks shuffled (seed %u)", state->card_seed);
+}
+
+static void init_scores(ScoreBoard *board) {
     for (int i = 0; i < MAX_PLAYERS; i++) {
-        snprintf(state->scores[i].name, sizeof(state->scores[i].name), 
+        snprintf(board->scores[i].name, sizeof(board->scores[i].name), 
                 "Player %d", i);
-        state->scores[i].wins = 0;
-        state->scores[i].games_played = 0;
+        board->scores[i].wins = 0;
+        board->scores[i].games_played = 0;
+    }
+    board->total_games = 0;
+}
+
+static void init_score_lock(ScoreBoard *board) {
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&board->lock, &mutex_attr);
+    pthread_mutexattr_destroy(&mutex_attr);
+}
+
+static void push_free_slot(uint32_t index) {
+    uint64_t head = __atomic_load_n(&slab->free_head, __ATOMIC_ACQUIRE);
+    uint64_t next;
+    do {
+        __atomic_store_n(&slab->slots[index].next_free, (uint32_t)head, __ATOMIC_RELAXED);
+        next = FREE_HEAD(index, (head >> 32) + 1);
+    } while (!__atomic_compare_exchange_n(&slab->free_head, &head, next, 1,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+// Returns the popped slot index, or ROOM_SLOTS if every slot is taken
+static uint32_t pop_free_slot(void) {
+    uint64_t head = __atomic_load_n(&slab->free_head, __ATOMIC_ACQUIRE);
+    while (1) {
+        uint32_t index = (uint32_t)head;
+        if (index >= ROOM_SLOTS) {
+            return ROOM_SLOTS;
+        }
+        uint32_t link = __atomic_load_n(&slab->slots[index].next_free, __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&slab->free_head, &head, FREE_HEAD(link, (head >> 32) + 1), 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return index;
+        }
+    }
+}
+
+// Fresh slab: every slot free and unlocked, scores from scratch
+static void init_slab(void) {
+    slab->free_head = FREE_HEAD(ROOM_SLOTS, 0);
+    slab->rooms_open = 0;
+    init_score_lock(&slab->scores);
+    init_scores(&slab->scores);
+    for (int i = ROOM_SLOTS - 1; i >= 0; i--) {
+        RoomSlot *slot = &slab->slots[i];
+        slot->state.seq = 0;
+        slot->refs = 0;
+        init_room_sync(&slot->state);
+        push_free_slot((uint32_t)i);
+    }
+}
+
+// Startup report of how the slab is mapped (huge pages, prefaulted)
+static void log_slab_mapping(void) {
+    char mode[96];
+    segment_describe(&room_segment, mode, sizeof(mode));
+    logger_log("Room slab ready: %d slots of %zu bytes (%s)", ROOM_SLOTS, sizeof(RoomSlot), mode);
+}
+
+// Create the room segment and its slab (server parent); children inherit it
+int init_room_slab(void) {
+    if (segment_create(&room_segment, room_shm_name(), room_parts, ROOM_PART_COUNT) != 0) {
+        logger_log("Failed to initialize shared memory");
+        return -1;
+    }
+    slab = segment_part(&room_segment, ROOM_PART_SLAB);
+    init_slab();
+    log_slab_mapping();
+    return 0;
+}
+
+static uint32_t journal_sum(const char *data, size_t bytes) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < bytes; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Board size a journal entry was written for (its spans follow from it)
+static int journal_board_size(const char *data) {
+    int board_size;
+    memcpy(&board_size, data + offsetof(GameState, board_size) - offsetof(GameState, game_state),
+           sizeof(board_size));
+    return board_size;
+}
+
+// Copy a finished commit into the room's older journal slot (game_mutex holder)
+static void journal_commit(RoomSlot *room, uint32_t seq) {
+    JournalSlot *slot = &room->journal[(seq >> 1) & 1];
+    StateSpan spans[STATE_SPANS];
+    state_spans(room->state.board_size, spans);
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    size_t bytes = 0;
+    for (int i = 0; i < STATE_SPANS; i++) {
+        memcpy(slot->data + bytes, (const char *)&room->state + spans[i].offset, spans[i].size);
+        bytes += spans[i].size;
+    }
+    slot->bytes = (uint32_t)bytes;
+    slot->sum = journal_sum(slot->data, bytes);
+    __atomic_store_n(&slot->seq, seq, __ATOMIC_RELEASE);
+}
+
+// Compare (restore = 0) or put back (restore = 1) a journal entry's spans;
+// returns 1 if the live state differs from it
+static int journal_apply(GameState *state, const JournalSlot *slot, int restore) {
+    StateSpan spans[STATE_SPANS];
+    state_spans(journal_board_size(slot->data), spans);
+    size_t bytes = 0;
+    int differs = 0;
+    for (int i = 0; i < STATE_SPANS; i++) {
+        char *live = (char *)state + spans[i].offset;
+        differs = differs || memcmp(live, slot->data + bytes, spans[i].size) != 0;
+        if (restore) {
+            memcpy(live, slot->data + bytes, spans[i].size);
+        }
+        bytes += spans[i].size;
+    }
+    return differs;
+}
+
+// Put the newest whole commit back if the live copy does not match it
+static void journal_recover(RoomSlot *room) {
+    GameState *state = &room->state;
+    const JournalSlot *best = NULL;
+    for (int i = 0; i < 2; i++) {
+        const JournalSlot *slot = &room->journal[i];
+        StateSpan spans[STATE_SPANS];
+        state_spans(journal_board_size(slot->data), spans);
+        size_t bytes = 0;
+        for (int s = 0; s < STATE_SPANS; s++) {
+            bytes += spans[s].size;
+        }
+        if (slot->seq != 0 && slot->bytes == bytes && journal_sum(slot->data, bytes) == slot->sum &&
+            (best == NULL || slot->seq > best->seq)) {
+            best = slot;
+        }
+    }
+    // An even seq newer than the journal means only the journal copy was cut short
+    if (best != NULL && ((state->seq & 1) || best->seq > state->seq ||
+                         (best->seq == state->seq && journal_apply(state, best, 0)))) {
+        logger_log("Room %d state was torn (seq %u); restored commit %u from the journal",
+                   (int)(room - slab->slots), state->seq, best->seq);
+        journal_apply(state, best, 1);
+    }
+}
+
+// Open a file-backed slab (server parent). A slab the file already holds
+// is kept (*kept = 1) along with the scores: rooms with a game in progress
+// resume where their last commit left them, each holding one reference
+// for the server (see room_at), and every other slot goes back on the
+// free list.
+int open_room_slab_file(const char *path, int *kept) {
+    int existing = segment_open_file(&room_segment, path, room_parts, ROOM_PART_COUNT);
+    if (existing < 0) {
+        logger_log("Failed to open room file %s", path);
+        return -1;
+    }
+    slab = segment_part(&room_segment, ROOM_PART_SLAB);
+    journaling = 1;
+    snprintf(room_file, sizeof(room_file), "%s", path);
+    *kept = existing;
+    log_slab_mapping();
+    if (!existing) {
+        init_slab();
+        return 0;
     }
     
-    return state;
+    // The free list is rebuilt from the reference counts: a crash may have
+    // cut a push or pop short, but never leaves a used slot at zero
+    init_score_lock(&slab->scores);
+    slab->free_head = FREE_HEAD(ROOM_SLOTS, 0);
+    slab->rooms_open = 0;
+    for (int i = ROOM_SLOTS - 1; i >= 0; i--) {
+        RoomSlot *slot = &slab->slots[i];
+        GameState *state = &slot->state;
+        init_room_sync(state);
+        if (slot->refs > 0) {
+            journal_recover(slot);
+            index_owners(state);
+        }
+        if (slot->refs > 0 && state->game_state == PLAYING) {
+            // The processes that were bidding or answering trades are gone
+            state->auction.open = 0;
+            state->trade_pending = 0;
+            state->win_pct_move = -1;
+            slot->refs = 1;
+            slab->rooms_open++;
+            logger_log("Resuming room %d from %s at turn %ld (round %d, P%d to play)",
+                       i, path, state->move_count, state->round, state->current_turn);
+            continue;
+        }
+        if (slot->refs > 0) {
+            slot->generation++;
+        }
+        slot->refs = 0;
+        push_free_slot((uint32_t)i);
+    }
+    return 0;
+}
+
+// Board registry part of the room segment (NULL until created or attached)
+BoardRegistry* game_state_boards(void) {
+    return segment_part(&room_segment, ROOM_PART_BOARDS);
 }
 
-// Wrapper: Attach to existing shared memory (for child processes)
-// Uses shared_memory.c to attach, then returns as GameState*
-GameState* attach_game_state_memory(void) {
-    SharedData *shm = attach_shared_memory(SHM_NAME, sizeof(SharedData));
-    if (shm == NULL) {
-        logger_log("Failed to attach to shared memory");
+// Destroy every slot's synchronization primitives, then unmap and remove
+// the segment (a file-backed slab is flushed and kept for the next start)
+void cleanup_room_slab(void) {
+    if (slab) {
+        for (int i = 0; i < ROOM_SLOTS; i++) {
+            destroy_room_sync(&slab->slots[i].state);
+        }
+        pthread_mutex_destroy(&slab->scores.lock);
+        slab = NULL;
+    }
+    if (room_file[0] != '\0') {
+        segment_sync(&room_segment);
+        segment_detach(&room_segment);
+        return;
+    }
+    segment_destroy(&room_segment, room_shm_name());
+}
+
+// Pop a free slot and set it up as an empty table, holding one reference
+// for the caller. Locks stay as the previous room left them: nobody holds
+// them once its last reference is gone. Returns ROOM_NONE if every slot
+// is in use.
+RoomHandle room_alloc(void) {
+    uint32_t index = pop_free_slot();
+    if (index >= ROOM_SLOTS) {
+        return ROOM_NONE;
+    }
+    RoomSlot *slot = &slab->slots[index];
+    reset_game_state(&slot->state);
+    __atomic_store_n(&slot->refs, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&slab->rooms_open, 1, __ATOMIC_RELAXED);
+    return (RoomHandle){ index, __atomic_load_n(&slot->generation, __ATOMIC_ACQUIRE) };
+}
+
+// The room a handle names, or NULL if it has been freed since
+GameState* room_get(RoomHandle handle) {
+    if (slab == NULL || handle.index >= ROOM_SLOTS) {
+        return NULL;
+    }
+    RoomSlot *slot = &slab->slots[handle.index];
+    if (__atomic_load_n(&slot->refs, __ATOMIC_ACQUIRE) <= 0 ||
+        __atomic_load_n(&slot->generation, __ATOMIC_ACQUIRE) != handle.generation) {
         return NULL;
     }
-    return (GameState *)shm;
+    return &slot->state;
+}
+
+RoomHandle room_handle(const GameState *state) {
+    const RoomSlot *slot = slot_of(state);
+    if (slot == NULL) {
+        return ROOM_NONE;
+    }
+    return (RoomHandle){ (uint32_t)(slot - slab->slots), __atomic_load_n(&slot->generation, __ATOMIC_ACQUIRE) };
+}
+
+// Room in use in a slot, or NULL if the slot is free
+GameState* room_at(int index) {
+    if (slab == NULL || index < 0 || index >= ROOM_SLOTS ||
+        __atomic_load_n(&slab->slots[index].refs, __ATOMIC_ACQUIRE) <= 0) {
+        return NULL;
+    }
+    return &slab->slots[index].state;
+}
+
+// Take a reference on the room in a slot unless the slot is free. The
+// count only moves up from a live value, so a slot being freed is never
+// revived; *handle names whichever room the reference was taken on.
+GameState* room_ref_at(int index, RoomHandle *handle) {
+    if (slab == NULL || index < 0 || index >= ROOM_SLOTS) {
+        return NULL;
+    }
+    RoomSlot *slot = &slab->slots[index];
+    int32_t refs = __atomic_load_n(&slot->refs, __ATOMIC_ACQUIRE);
+    do {
+        if (refs <= 0) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&slot->refs, &refs, refs + 1, 1,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    *handle = (RoomHandle){ (uint32_t)index, __atomic_load_n(&slot->generation, __ATOMIC_ACQUIRE) };
+    return &slot->state;
+}
+
+int rooms_open(void) {
+    return slab ? (int)__atomic_load_n(&slab->rooms_open, __ATOMIC_RELAXED) : 0;
+}
+
+void room_ref(GameState *state) {
+    RoomSlot *slot = slot_of(state);
+    if (slot) {
+        __atomic_add_fetch(&slot->refs, 1, __ATOMIC_ACQ_REL);
+    }
 }
 
-// Wrapper: Cleanup shared memory
-// Destroys synchronization primitives and calls shared_memory.c cleanup
-void cleanup_game_state_memory(GameState *state) {
-    if (state) {
-        pthread_mutex_destroy(&state->game_mutex);
-        pthread_mutex_destroy(&state->score_mutex);
-        pthread_cond_destroy(&state->turn_cond);
-        sem_destroy(&state->log_sem);
+// Drop a reference; the last one out returns the slot to the free list
+// (not while holding the room's locks: the slot may be reused at once)
+void room_unref(GameState *state) {
+    RoomSlot *slot = slot_of(state);
+    if (slot == NULL || __atomic_sub_fetch(&slot->refs, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    __atomic_add_fetch(&slot->generation, 1, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&slab->rooms_open, 1, __ATOMIC_RELAXED);
+    push_free_slot((uint32_t)(slot - slab->slots));
+}
+
+// Set up a room to play on a board (every tile starts with the bank)
+void init_board(GameState *state, const BoardDef *board) {
+    state_write_begin(state);
+    snprintf(state->board_name, sizeof(state->board_name), "%s", board->name);
+    state->board_size = (int)board->tile_count;
+    state->start_money = board->start_money;
+    memset(state->buildings, 0, sizeof(state->buildings));
+    memset(state->tile_rent, 0, sizeof(state->tile_rent));
+    for (int i = 0; i < MAX_BOARD_SIZE; i++) {
+        state->board_owner[i] = -1;
     }
-    // Use shared_memory.c's cleanup function
-    clean_shared_memory((SharedData *)state, SHM_NAME, sizeof(SharedData));
+    index_owners(state);
+    state_write_end(state);
 }
 
-// Initialize board with properties
-void init_board(GameState *state) {
-    const char *property_names[BOARD_SIZE] = {
-        "Go", "Pasar Seni", "Community Chest", "Batu Caves",
-        "Income Tax", "KL Sentral", "George Town", "Chance",
-        "Langkawi", "Penang Hill", "Tax Office", "Melaka Old Town",
-        "TNB HQ", "Putrajaya", "Cameron Highlands", "KLCC",
-        "Genting Highlands", "Community Chest", "Johor Bahru", "Mount Kinabalu"
-    };
+// Shuffle both card decks and seed the dice from one recorded seed
+void init_decks(GameState *state, unsigned int seed) {
+    state_write_begin(state);
+    state->card_seed = seed;
+    state->dice_seed = seed ^ 0x9e3779b9u;
+    for (int d = 0; d < DECK_COUNT; d++) {
+        deck_init(&state->decks[d], (DeckId)d, seed + (unsigned int)d * 2654435761u);
+    }
+    state_write_end(state);
+}
+
+void state_write_begin(GameState *state) {
+    if (state->write_depth++ == 0) {
+        __atomic_store_n(&state->seq, state->seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+}
+
+void state_write_end(GameState *state) {
+    if (--state->write_depth == 0) {
+        uint32_t seq = state->seq + 1;
+        __atomic_store_n(&state->seq, seq, __ATOMIC_RELEASE);
+        RoomSlot *slot = journaling ? slot_of(state) : NULL;
+        if (slot != NULL) {
+            journal_commit(slot, seq);
+        }
+    }
+}
+
+// Seqlock read: copy, then keep the copy only if seq was even and unchanged
+uint32_t game_state_snapshot(const GameState *state, GameState *copy) {
+    memset(copy, 0, sizeof(GameState));
     
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        strncpy(state->board[i].name, property_names[i], 31);
-        state->board[i].name[31] = '\0';
-        state->board[i].price = 100 + (i * 20);
-        state->board[i].rent = 10 + (i * 5);
-        state->board[i].owner = -1;
+    while (1) {
+        uint32_t seq = __atomic_load_n(&state->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            sched_yield();      // A commit is writing; it is short
+            continue;
+        }
+        // The fixed fields first: the tile spans follow from the copied board_size
+        StateSpan spans[STATE_SPANS];
+        state_spans(0, spans);
+        memcpy((char *)copy + spans[0].offset, (const char *)state + spans[0].offset, spans[0].size);
+        state_spans(copy->board_size, spans);
+        for (int i = 1; i < STATE_SPANS; i++) {
+            memcpy((char *)copy + spans[i].offset, (const char *)state + spans[i].offset, spans[i].size);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&state->seq, __ATOMIC_RELAXED) == seq) {
+            copy->seq = seq;
+            copy->write_depth = 0;
+            return seq;
+        }
     }
 }
 
 // Load scores from file
-void load_scores(GameState *state) {
-    FILE *f = fopen(SCORES_FILE, "r");
+void load_scores(void) {
+    FILE *f = fopen(scores_file(), "r");
     if (!f) {
         return;  // File doesn't exist yet
     }
     
-    pthread_mutex_lock(&state->score_mutex);
+    ScoreBoard *board = &slab->scores;
+    sync_mutex_lock(&board->lock);
     
-    if (fscanf(f, "Total Games: %d\n", &state->total_games) != 1) {
-        state->total_games = 0;
+    if (fscanf(f, "Total Games: %d\n", &board->total_games) != 1) {
+        board->total_games = 0;
     }
     
     for (int i = 0; i < MAX_PLAYERS; i++) {
         int id, wins, games;
         char name[32];
         if (fscanf(f, "Player %d: %31s - %d wins / %d games\n", 
-                   &id, name, &wins, &games) == 4) {
-            state->scores[i].wins = wins;
-            state->scores[i].games_played = games;
-            snprintf(state->scores[i].name, sizeof(state->scores[i].name), "%s", name);
+                   &id, name, &wins, &games) == 4 && id >= 0 && id < MAX_PLAYERS) {
+            board->scores[id].wins = wins;
+            board->scores[id].games_played = games;
+            snprintf(board->scores[id].name, sizeof(board->scores[id].name), "%s", name);
         }
     }
     
-    pthread_mutex_unlock(&state->score_mutex);
+    pthread_mutex_unlock(&board->lock);
     fclose(f);
 }
 
 // Save scores to file (atomic with mutex protection)
-void save_scores(GameState *state) {
-    pthread_mutex_lock(&state->score_mutex);
+void save_scores(void) {
+    if (slab == NULL) {
+        return;
+    }
+    ScoreBoard *board = &slab->scores;
+    sync_mutex_lock(&board->lock);
     
-    FILE *f = fopen(SCORES_FILE, "w");
+    FILE *f = fopen(scores_file(), "w");
     if (!f) {
-        pthread_mutex_unlock(&state->score_mutex);
+        pthread_mutex_unlock(&board->lock);
         return;
     }
     
-    fprintf(f, "Total Games: %d\n", state->total_games);
+    fprintf(f, "Total Games: %d\n", board->total_games);
     
+    // Seats that never played are left out (party tables go up to MAX_PLAYERS)
     for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (board->scores[i].games_played == 0) {
+            continue;
+        }
         fprintf(f, "Player %d: %s - %d wins / %d games\n",
-                i, state->scores[i].name,
-                state->scores[i].wins,
-                state->scores[i].games_played);
+                i, board->scores[i].name,
+                board->scores[i].wins,
+                board->scores[i].games_played);
     }
     
     fclose(f);
-    pthread_mutex_unlock(&state->score_mutex);
+    pthread_mutex_unlock(&board->lock);
 }
 
-// Advance to next active player's turn
-void advance_turn(GameState *state) {
-    int attempts = 0;
-    do {
-        state->current_turn = (state->current_turn + 1) % state->num_players;
-        attempts++;
-    } while (state->players[state->current_turn].is_bankrupt && 
-             attempts < MAX_PLAYERS);
+// Advance to next active player's turn; returns 1 if that ended the game
+int next_turn(GameState *state) {
+    state_write_begin(state);
+    state->move_count++;
     
-    // Check if we completed a round
-    if (state->current_turn == 0) {
-        state->round++;
+    // Next seat still in, wrapping round the table (a round ends on the wrap)
+    int next = seat_next(state->alive_mask, state->current_turn);
+    if (next >= 0) {
+        if (next <= state->current_turn) {
+            state->round++;
+        }
+        state->current_turn = next;
     }
     
     // Check win condition
-    int active_count = 0;
-    int winner_id = -1;
+    int over = alive_count(state) <= 1;
+    if (over) {
+        state->game_state = GAME_OVER;
+    }
+    state_write_end(state);
+    return over;
+}
+
+// Advance the turn and wake whoever plays next (everyone once the game
+// ends, after recording the result)
+void advance_turn(GameState *state) {
+    if (!next_turn(state)) {
+        wake_seat(state, state->current_turn);
+        return;
+    }
+    
+    wake_all_seats(state);
+    int winner_id = get_winner(state);
+    if (winner_id >= 0 && slab != NULL) {
+        ScoreBoard *board = &slab->scores;
+        sync_mutex_lock(&board->lock);
+        board->scores[winner_id].wins++;
+        for (int i = 0; i < state->num_players; i++) {
+            board->scores[i].games_played++;
+        }
+        board->total_games++;
+        pthread_mutex_unlock(&board->lock);
+        logger_log("Game over! Player %d wins!", winner_id);
+        save_scores();
+    }
+}
+
+void wake_seat(GameState *state, int player_id) {
+    if (player_id >= 0 && player_id < MAX_PLAYERS) {
+        pthread_cond_signal(&state->seat_wake[player_id].cond);
+    }
+}
+
+void wake_all_seats(GameState *state) {
     for (int i = 0; i < state->num_players; i++) {
-        if (!state->players[i].is_bankrupt && state->players[i].is_active) {
-            active_count++;
-            winner_id = i;
+        pthread_cond_signal(&state->seat_wake[i].cond);
+    }
+}
+
+// game_mutex came back from a holder that died mid-turn. Whatever it was
+// committing stays as far as it got; make that state self-consistent,
+// take the dead seat out like a disconnect and pass its turn on.
+static void repair_game_state(GameState *state) {
+    int dead = state->lock_owner;
+    logger_log("game_mutex owner (seat %d) died; repairing the room", dead);
+    
+    // An interrupted commit leaves seq odd, which would stall every reader
+    if (state->write_depth != 0 || (state->seq & 1)) {
+        state->write_depth = 0;
+        __atomic_store_n(&state->seq, (state->seq | 1) + 1, __ATOMIC_RELEASE);
+    }
+    
+    state_write_begin(state);
+    // board_owner[] is authoritative; the bitboards and rents follow from it
+    for (int t = 0; t < state->board_size; t++) {
+        int owner = state->board_owner[t];
+        if (owner < -1 || owner >= state->num_players) {
+            state->board_owner[t] = -1;
         }
     }
+    index_owners(state);
+    const BoardDef *board = state->board_version != 0
+                                ? board_registry_map(game_state_boards(), state->board_version) : NULL;
+    if (board) {
+        build_rent_table(board, state->board_owner, state->buildings, state->tile_rent);
+        board_registry_release(board);
+    }
     
-    if (active_count <= 1) {
-        state->game_state = GAME_OVER;
-        if (winner_id >= 0) {
-            pthread_mutex_lock(&state->score_mutex);
-            state->scores[winner_id].wins++;
-            for (int i = 0; i < state->num_players; i++) {
-                state->scores[i].games_played++;
-            }
-            state->total_games++;
-            pthread_mutex_unlock(&state->score_mutex);
-            logger_log("Game over! Player %d wins!", winner_id);
-            save_scores(state);
+    SeatMask alive = 0;
+    for (int i = 0; i < state->num_players; i++) {
+        Player *player = &state->players[i];
+        if (player->position < 0 || player->position >= state->board_size) {
+            player->position = 0;
+        }
+        if (i == dead) {
+            player->is_active = 0;
+        }
+        if (player->is_active && !player->is_bankrupt) {
+            alive |= seat_bit(i);
+        }
+    }
+    state->alive_mask = alive;
+    state_write_end(state);
+    
+    if (dead >= 0 && dead < state->num_players) {
+        touch_assets(state, dead);      // Stales trades addressed to it
+        int price;
+        if (state->auction.open && state->auction.seller == dead) {
+            auction_close(&state->auction, &price);     // No sale
         }
+        if (state->game_state == PLAYING && state->current_turn == dead) {
+            advance_turn(state);
+        }
+        room_unref(state);     // The dead seat's reference (never the last: the caller holds one)
+    }
+}
+
+// Recover game_mutex after EOWNERDEAD (held on entry). On failure the
+// mutex is released, which leaves it unrecoverable for every process.
+static int recover_game_state(GameState *state) {
+    repair_game_state(state);
+    if (pthread_mutex_consistent(&state->game_mutex) != 0) {
+        fprintf(stderr, "[GAME] Error: game_mutex could not be recovered\n");
+        pthread_mutex_unlock(&state->game_mutex);
+        return -1;
+    }
+    return 1;
+}
+
+// Finish taking game_mutex after lock or wait returned `rc`: 0 if held,
+// 1 if held after a repair, -1 if not held
+static int acquired(GameState *state, int rc, int seat) {
+    int status = 0;
+    if (rc == EOWNERDEAD) {
+        status = recover_game_state(state);
+    } else if (rc != 0) {
+        fprintf(stderr, "[GAME] Error: cannot lock game_mutex: %s\n", strerror(rc));
+        status = -1;
+    }
+    if (status >= 0) {
+        state->lock_owner = seat;
+    }
+    return status;
+}
+
+int lock_game_state(GameState *state, int seat) {
+    return acquired(state, pthread_mutex_lock(&state->game_mutex), seat);
+}
+
+int wait_seat(GameState *state, int player_id, const struct timespec *deadline) {
+    pthread_cond_t *cond = &state->seat_wake[player_id].cond;
+    int rc = deadline ? pthread_cond_timedwait(cond, &state->game_mutex, deadline)
+                      : pthread_cond_wait(cond, &state->game_mutex);
+    if (rc == ETIMEDOUT) {
+        state->lock_owner = player_id;      // Reacquired all the same
+        return rc;
     }
+    return acquired(state, rc, player_id) < 0 ? -1 : 0;
 }
 
-// Get winner ID
+// Get winner ID (the last seat still in, -1 if nobody is)
 int get_winner(GameState *state) {
-    for (int i = 0; i < state->num_players; i++) {
-        if (!state->players[i].is_bankrupt && state->players[i].is_active) {
-            return i;
+    return seat_first(state->alive_mask);
+}
+
+void seat_join(GameState *state, int player_id) {
+    state_write_begin(state);
+    state->players[player_id].is_active = 1;
+    state->players[player_id].is_bankrupt = 0;
+    state->alive_mask |= seat_bit(player_id);
+    state_write_end(state);
+}
+
+void seat_leave(GameState *state, int player_id) {
+    state_write_begin(state);
+    state->players[player_id].is_active = 0;
+    state->alive_mask &= ~seat_bit(player_id);
+    state_write_end(state);
+}
+
+// Mark a player's cash or tiles as changed (stales their pending trades)
+void touch_assets(GameState *state, int player_id) {
+    __atomic_add_fetch(&state->asset_version[player_id], 1, __ATOMIC_RELEASE);
+}
+
+// Bitboard words a board of board_size tiles uses
+static int owned_words(const GameState *state) {
+    return (state->board_size + 63) / 64;
+}
+
+void index_owners(GameState *state) {
+    memset(state->owned_bits, 0, sizeof(state->owned_bits));
+    for (int t = 0; t < state->board_size; t++) {
+        int owner = state->board_owner[t];
+        if (owner >= 0 && owner < MAX_PLAYERS) {
+            state->owned_bits[owner][t / 64] |= 1ULL << (t % 64);
+        }
+    }
+}
+
+// Give a tile to a player (-1 returns it to the bank)
+void set_property_owner(GameState *state, const BoardDef *board, int tile, int player_id) {
+    uint64_t bit = 1ULL << (tile % 64);
+    state_write_begin(state);
+    int old_owner = state->board_owner[tile];
+    if (old_owner >= 0) {
+        state->owned_bits[old_owner][tile / 64] &= ~bit;
+        touch_assets(state, old_owner);
+    }
+    if (player_id >= 0) {
+        state->owned_bits[player_id][tile / 64] |= bit;
+        touch_assets(state, player_id);
+    }
+    state->board_owner[tile] = player_id;
+    
+    // Completing or breaking a group changes every rent in it
+    update_group_rents(board, tile, state->board_owner, state->buildings, state->tile_rent);
+    state_write_end(state);
+}
+
+// Return every tile a player owns to the bank, buildings included; returns
+// how many there were. A monopoly is never split between players, so no
+// other player's rent changes.
+int release_properties(GameState *state, int player_id) {
+    int count = 0;
+    state_write_begin(state);
+    for (int w = 0; w < owned_words(state); w++) {
+        uint64_t owned = state->owned_bits[player_id][w];
+        count += __builtin_popcountll(owned);
+        while (owned) {
+            int tile = w * 64 + __builtin_ctzll(owned);
+            owned &= owned - 1;
+            state->board_owner[tile] = -1;
+            state->buildings[tile] = 0;
+            state->tile_rent[tile] = 0;
+        }
+        state->owned_bits[player_id][w] = 0;
+    }
+    state_write_end(state);
+    touch_assets(state, player_id);
+    return count;
+}
+
+// Number of tiles a player owns
+int portfolio_count(const GameState *state, int player_id) {
+    int count = 0;
+    for (int w = 0; w < owned_words(state); w++) {
+        count += __builtin_popcountll(state->owned_bits[player_id][w]);
+    }
+    return count;
+}
+
+// Total purchase price of a player's tiles
+int portfolio_value(const GameState *state, const BoardDef *board, int player_id) {
+    int value = 0;
+    for (int w = 0; w < owned_words(state); w++) {
+        for (uint64_t owned = state->owned_bits[player_id][w]; owned; owned &= owned - 1) {
+            value += board->tiles[w * 64 + __builtin_ctzll(owned)].price;
+        }
+    }
+    return value;
+}
+
+// 1 if the player owns every tile in the list (up to count, or the first TILE_NONE)
+int owns_all(const GameState *state, int player_id, const uint16_t tiles[], int count) {
+    for (int i = 0; i < count && tiles[i] != TILE_NONE; i++) {
+        if (tiles[i] >= state->board_size || !owns_tile(state, player_id, tiles[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 1 if the player owns the whole color group of a grouped tile: the
+// group's span masked against the 64 bitboard bits from its first tile
+int owns_group(const GameState *state, const BoardDef *board, int player_id, int tile) {
+    const GroupSpan *span = board_group_span(board, board->tiles[tile].group);
+    const uint64_t *owned = state->owned_bits[player_id];
+    int word = span->first / 64;
+    int shift = span->first % 64;
+    uint64_t bits = owned[word] >> shift;
+    if (shift != 0 && word + 1 < OWNED_WORDS) {
+        bits |= owned[word + 1] << (64 - shift);
+    }
+    return span->mask != 0 && (bits & span->mask) == span->mask;
+}
+
+// 1 if the player may add one building level to a tile: they own its whole
+// group, the board has a rent for the next level, building stays even
+// across the group and they can pay for it
+int can_build(const GameState *state, const BoardDef *board, int tile, int player_id) {
+    const Property *prop = &board->tiles[tile];
+    int level = state->buildings[tile];
+    if (prop->group == 0 || prop->house_price == 0 || level >= BOARD_HOTEL ||
+        prop->rent[level + 1] == 0 || state->players[player_id].money < prop->house_price) {
+        return 0;
+    }
+    
+    if (!owns_group(state, board, player_id, tile)) {
+        return 0;
+    }
+    int t = tile;
+    do {
+        if (state->buildings[t] < level) {
+            return 0;
+        }
+    } while ((t = board_group_next(board, t)) != tile);
+    return 1;
+}
+
+// Add one building level to a tile and charge the player. Returns 0, or -1
+// if can_build() says no.
+int build_house(GameState *state, const BoardDef *board, int tile, int player_id) {
+    if (!can_build(state, board, tile, player_id)) {
+        return -1;
+    }
+    state_write_begin(state);
+    state->players[player_id].money -= board->tiles[tile].house_price;
+    state->buildings[tile]++;
+    update_group_rents(board, tile, state->board_owner, state->buildings, state->tile_rent);
+    state_write_end(state);
+    touch_assets(state, player_id);
+    return 0;
+}
+
+// Cheapest tile the player can build on next (fewest buildings, then lowest
+// house price, then lowest tile number), or -1 if there is none
+int pick_build_tile(const GameState *state, const BoardDef *board, int player_id) {
+    int best = -1;
+    for (int w = 0; w < owned_words(state); w++) {
+        for (uint64_t owned = state->owned_bits[player_id][w]; owned; owned &= owned - 1) {
+            int tile = w * 64 + __builtin_ctzll(owned);
+            if (!can_build(state, board, tile, player_id)) {
+                continue;
+            }
+            // Tiles come in increasing order, so ties keep the lower tile
+            if (best < 0 || state->buildings[tile] < state->buildings[best] ||
+                (state->buildings[tile] == state->buildings[best] &&
+                 board->tiles[tile].house_price < board->tiles[best].house_price)) {
+                best = tile;
+            }
         }
     }
-    return -1;
+    return best;
 }
@@ -2,14 +2,22 @@
 #define GAME_STATE_H
 
 #include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <semaphore.h>
+#include "board.h"
+#include "board_registry.h"
+#include "cards.h"
+#include "auction.h"
+#include "seats.h"
 
-#define MAX_PLAYERS 5
-#define MIN_PLAYERS 3
-#define BOARD_SIZE 20
-#define START_MONEY 500   // Lower starting money for faster bankruptcies
-#define SHM_NAME "/monopoly_game_shm"
-#define SCORES_FILE "scores.txt"
+#define START_MONEY 500   // Default when a board does not set start_money
+#define SHM_BASE_NAME "game_shm"    // Room segment, see instance_ipc_name()
+#define SCORES_FILE "scores.txt"    // Per instance, see instance_file_name()
+#define ROOM_SLOTS 64               // Rooms one server runs at once (slots of the room slab)
+#define TILE_NONE 0xffff            // End of a trade tile list
+#define OWNED_WORDS (MAX_BOARD_SIZE / 64)   // Words in a seat's tile bitboard
+#define TRADE_MAX_TILES 4           // Tiles each side of a trade may move
 
 // Game states
 typedef enum {
@@ -24,24 +32,19 @@ typedef enum {
     MSG_YOUR_TURN,
     MSG_UPDATE,
     MSG_WIN,
-    MSG_LOSE
+    MSG_LOSE,
+    MSG_AUCTION,    // Sealed bid wanted: position = tile, money = bidder's cash
+    MSG_TRADE       // Trade offer to accept or refuse (details in message)
 } MessageType;
 
-// Property structure
+// Player structure (8 bytes: eight seats' turn data per cache line).
+// is_active and is_bankrupt are mirrored in GameState.alive_mask; change
+// them through seat_join(), seat_leave() and declare_bankrupt().
 typedef struct {
-    char name[32];
-    int price;
-    int rent;
-    int owner;  // -1 = unowned, 0-4 = player id
-} Property;
-
-// Player structure
-typedef struct {
-    int id;
-    int position;
-    int money;
-    int is_active;
-    int is_bankrupt;
+    int32_t money;
+    int16_t position;
+    uint8_t is_active;
+    uint8_t is_bankrupt;
 } Player;
 
 // Player score tracking
@@ -57,44 +60,217 @@ typedef struct {
     int player_id;
     int position;
     int money;
+    uint32_t reply_id;      // MSG_AUCTION / MSG_TRADE: echo back in the reply
     char message[256];
 } Packet;
 
+// Trade proposal: cash and tiles between two players. Clients fill in
+// to, cash, give and take; the server stamps the rest.
+typedef struct {
+    uint32_t id;                // Room-wide sequence number, echoed in the reply
+    int from;                   // Proposer
+    int to;                     // Counterparty
+    int32_t cash;               // Paid by `from` to `to` (negative: `to` pays)
+    uint16_t give[TRADE_MAX_TILES];     // Tiles `from` hands over (TILE_NONE-terminated if short)
+    uint16_t take[TRADE_MAX_TILES];     // Tiles `from` asks for (same)
+    uint32_t from_version;      // asset_version[] both sides had when it was made
+    uint32_t to_version;
+} TradeOffer;
+
+// One seat's wakeup, on its own line. Each child sleeps on its own seat
+// (with game_mutex), so a turn change wakes exactly the next player
+// instead of every child in the room.
+typedef struct {
+    pthread_cond_t cond;
+} __attribute__((aligned(64))) SeatWake;
+
 // Main game state (shared memory structure)
+//
+// Changes happen under game_mutex. Everything from game_state through the
+// card decks is also covered by `seq`, a seqlock: commits bump it to odd
+// before writing and back to even after, so observers in any process can
+// copy that range without the mutex (game_state_snapshot) and never hold
+// up a turn.
+//
+// Laid out in cache-line aligned regions by who writes them, so the
+// children spinning on the turn data do not bounce lines that other
+// processes (bidders, trade partners, the estimator) write meanwhile:
+// each lock on its own line, then the hot turn data (with the seat
+// masks), the players packed together, then board, auction and trade
+// regions, and the cold fields (names, paths, scores) at the end.
+//
+// Tables hold up to MAX_PLAYERS seats and boards up to MAX_BOARD_SIZE
+// tiles; per-tile arrays are only used (and copied) up to board_size.
 typedef struct {
-    // Synchronization primitives (MUST be process-shared)
-    pthread_mutex_t game_mutex;
-    pthread_mutex_t score_mutex;
-    pthread_cond_t turn_cond;
-    sem_t log_sem;
+    // Synchronization primitives (MUST be process-shared), one line each
+    pthread_mutex_t game_mutex __attribute__((aligned(64)));
+    int lock_owner;             // Seat holding game_mutex (-1 = server), see lock_game_state
+    SeatWake seat_wake[MAX_PLAYERS];
+    pthread_mutex_t trade_mutex __attribute__((aligned(64)));  // Guards the trade inbox only, never held with game_mutex waits
+    sem_t log_sem __attribute__((aligned(64)));
     
-    // Game state
-    GameStatus game_state;
+    // Hot: turn control in one line, read on every wakeup (under game_mutex)
+    GameStatus game_state __attribute__((aligned(64)));
     int num_players;
-    int active_player_count;
     int current_turn;
+    uint32_t seq;               // Odd while a commit is writing (see game_state_snapshot)
+    long move_count;            // Turns committed so far (bumped by next_turn)
+    SeatMask alive_mask;        // Seats active and not bankrupt: turn order and the win check
+    
+    Player players[MAX_PLAYERS] __attribute__((aligned(64)));
+    
+    // Board (tile data lives in the shared read-only BoardDef; rooms keep owners)
+    uint32_t board_version __attribute__((aligned(64)));  // Pinned registry version while PLAYING, 0 otherwise
     int round;
+    int write_depth;                    // Nesting of state_write_begin() (game_mutex holder only)
+    int board_size;
+    int start_money;
+    
+    // Card decks (drawn under game_mutex; card_seed reproduces every shuffle)
+    CardDeck decks[DECK_COUNT] __attribute__((aligned(64)));
+    unsigned int card_seed;
+    unsigned int dice_seed;     // Advanced by every roll (seeded from card_seed at game start)
     
-    // Players
-    Player players[MAX_PLAYERS];
+    // Per-tile state, last in the seqlock range: only board_size entries
+    // of each array are copied (see game_state_snapshot)
+    uint8_t buildings[MAX_BOARD_SIZE] __attribute__((aligned(64)));  // Building level: 0 = none, 1-4 houses, BOARD_HOTEL
+    int board_owner[MAX_BOARD_SIZE] __attribute__((aligned(64)));   // -1 = unowned, otherwise player id
+    int tile_rent[MAX_BOARD_SIZE] __attribute__((aligned(64)));     // Rent due on landing, refreshed on ownership/building events
     
-    // Board
-    Property board[BOARD_SIZE];
+    // Auction of a tile the current player passed on (changed under game_mutex)
+    Auction auction __attribute__((aligned(64)));
     
-    // Persistent scores
-    PlayerScore scores[MAX_PLAYERS];
-    int total_games;
+    // Each seat's tiles as a bitboard (bit t of word t / 64 = owns tile t):
+    // portfolio counts are popcounts, group and set checks are masks, and
+    // walks skip empty words. Derived from board_owner[] (kept in step by
+    // set_property_owner, rebuilt by index_owners after a repair or
+    // restore), so outside the seqlock range.
+    uint64_t owned_bits[MAX_PLAYERS][OWNED_WORDS] __attribute__((aligned(64)));
+    
+    // Trades: asset_version[p] is bumped (under game_mutex) whenever p's cash or
+    // tiles change, so an offer made against older versions is stale
+    uint32_t asset_version[MAX_PLAYERS] __attribute__((aligned(64)));
+    SeatMask trade_pending;                 // bit p = trade_inbox[p] holds an offer
+    uint32_t trade_seq;
+    TradeOffer trade_inbox[MAX_PLAYERS];    // One pending offer per recipient
+    
+    // Live win-probability estimate (written by the estimator thread only)
+    int win_pct[MAX_PLAYERS] __attribute__((aligned(64)));
+    long win_pct_move;          // move_count the estimate belongs to, -1 if none
+    
+    // Cold: names and paths
+    char board_name[32] __attribute__((aligned(64)));
+    char replay_path[64];       // Recording of the game in progress ("" = not recording)
+    SeatMask bot_mask;          // Seats played by bots (re-forked after a warm restart)
+    SeatMask vacant_mask;       // Human seats cut off by a restart, free to reconnect to
     
 } GameState;
 
+_Static_assert(offsetof(GameState, alive_mask) + sizeof(SeatMask) -
+               offsetof(GameState, game_state) <= 64, "hot turn data must stay one cache line");
+_Static_assert(sizeof(Player) == 8, "eight players per cache line");
+_Static_assert(MAX_PLAYERS <= AUCTION_MAX_SEATS, "auction seat masks too narrow for MAX_PLAYERS");
+
+// Rooms live in ROOM_SLOTS fixed slots of one shared slab, created by the
+// server parent and inherited by its children. A handle names a room by
+// slot and generation; the generation changes whenever the slot is freed,
+// so a handle outliving its room is detected instead of reaching the next.
+typedef struct {
+    uint32_t index;
+    uint32_t generation;
+} RoomHandle;
+
+#define ROOM_NONE ((RoomHandle){ ROOM_SLOTS, 0 })
+
 // Function declarations
-GameState* init_game_state_memory(void);
-GameState* attach_game_state_memory(void);
-void cleanup_game_state_memory(GameState *state);
-void load_scores(GameState *state);
-void save_scores(GameState *state);
-void init_board(GameState *state);
+int init_room_slab(void);
+int open_room_slab_file(const char *path, int *kept);
+void cleanup_room_slab(void);
+BoardRegistry* game_state_boards(void);
+void reset_game_state(GameState *state);
+void load_scores(void);
+void save_scores(void);
+
+// Room slots. room_alloc() pops a free slot (O(1), lock-free) as an empty
+// table holding one reference for the caller; every process using a room
+// holds its own (room_ref) and drops it on the way out (room_unref), and
+// the last one out pushes the slot back. room_get() returns NULL for a
+// stale handle, room_at() the room in a slot or NULL if it is free, and
+// room_ref_at() the same with a reference taken (drop it with room_unref).
+RoomHandle room_alloc(void);
+GameState* room_get(RoomHandle handle);
+RoomHandle room_handle(const GameState *state);
+GameState* room_at(int index);
+GameState* room_ref_at(int index, RoomHandle *handle);
+int rooms_open(void);
+void room_ref(GameState *state);
+void room_unref(GameState *state);
+
+void init_board(GameState *state, const BoardDef *board);
+void init_decks(GameState *state, unsigned int seed);
+int next_turn(GameState *state);
 void advance_turn(GameState *state);
 int get_winner(GameState *state);
 
+// Seats still in the game (active and not bankrupt), from alive_mask
+static inline int seat_is_alive(const GameState *state, int player_id) {
+    return (state->alive_mask >> player_id) & 1;
+}
+
+static inline int alive_count(const GameState *state) {
+    return seat_count(state->alive_mask);
+}
+
+// Seat changes (caller holds game_mutex): seat_join() puts a player in
+// (fresh or rejoining), seat_leave() takes them out without releasing
+// their tiles; declare_bankrupt() (turn.h) does both ends of going broke.
+void seat_join(GameState *state, int player_id);
+void seat_leave(GameState *state, int player_id);
+
+// Lock game_mutex on behalf of `seat` (-1 for the server itself). The
+// mutex is robust: if its holder died, the room is repaired (interrupted
+// commit, dead seat taken out and its turn passed on) and 1 is returned.
+// Returns -1, without the lock, if it cannot be taken or the room cannot
+// be recovered; the caller must give up on the room.
+int lock_game_state(GameState *state, int seat);
+
+// Per-seat wakeups (caller holds game_mutex). wait_seat() sleeps until the
+// seat is woken or `deadline` (CLOCK_REALTIME, NULL = none) passes, and
+// returns ETIMEDOUT in the latter case, or -1 with game_mutex lost like
+// lock_game_state().
+void wake_seat(GameState *state, int player_id);
+void wake_all_seats(GameState *state);
+int wait_seat(GameState *state, int player_id, const struct timespec *deadline);
+
+// Seqlock around changes to the turn, board and deck regions (caller holds
+// game_mutex; calls nest, only the outermost pair bumps seq)
+void state_write_begin(GameState *state);
+void state_write_end(GameState *state);
+
+// Consistent copy of the turn, board and deck regions without game_mutex;
+// retries while a commit overlaps. Other fields of `copy` are zeroed, and
+// its locks are not usable. Returns the seq the copy belongs to.
+uint32_t game_state_snapshot(const GameState *state, GameState *copy);
+
+// Ownership (board_owner[], owned_bits[] and tile_rent[] change together; caller holds game_mutex)
+void touch_assets(GameState *state, int player_id);
+void set_property_owner(GameState *state, const BoardDef *board, int tile, int player_id);
+int release_properties(GameState *state, int player_id);
+int portfolio_count(const GameState *state, int player_id);
+int portfolio_value(const GameState *state, const BoardDef *board, int player_id);
+int owns_all(const GameState *state, int player_id, const uint16_t tiles[], int count);
+int owns_group(const GameState *state, const BoardDef *board, int player_id, int tile);
+
+static inline int owns_tile(const GameState *state, int player_id, int tile) {
+    return (state->owned_bits[player_id][tile / 64] >> (tile % 64)) & 1;
+}
+
+// Rebuild owned_bits[] from board_owner[] (after it was written wholesale)
+void index_owners(GameState *state);
+
+// Buildings (caller holds game_mutex)
+int can_build(const GameState *state, const BoardDef *board, int tile, int player_id);
+int build_house(GameState *state, const BoardDef *board, int tile, int player_id);
+int pick_build_tile(const GameState *state, const BoardDef *board, int player_id);
+
 #endif // GAME_STATE_H
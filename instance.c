@@ -0,0 +1,68 @@
+#include "instance.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char instance[INSTANCE_NAME_MAX + 1];
+
+int instance_init(const char *name) {
+    if (name == NULL) {
+        name = getenv(INSTANCE_ENV);
+    }
+    if (name == NULL) {
+        name = "";
+    }
+
+    size_t len = strlen(name);
+    if (len > INSTANCE_NAME_MAX || strspn(name, "abcdefghijklmnopqrstuvwxyz"
+                                                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                                "0123456789_-") != len) {
+        fprintf(stderr, "[INSTANCE] Error: instance name must be up to %d of [A-Za-z0-9_-], got \"%s\"\n",
+                INSTANCE_NAME_MAX, name);
+        return -1;
+    }
+    memcpy(instance, name, len + 1);
+    return 0;
+}
+
+const char *instance_name(void) {
+    return instance;
+}
+
+void instance_ipc_name(char *out, size_t size, const char *base) {
+    if (instance[0] == '\0') {
+        snprintf(out, size, "/monopoly_%s", base);
+    } else {
+        snprintf(out, size, "/monopoly.%s_%s", instance, base);
+    }
+}
+
+void instance_file_name(char *out, size_t size, const char *file) {
+    const char *ext = strrchr(file, '.');
+    if (instance[0] == '\0') {
+        snprintf(out, size, "%s", file);
+    } else if (ext == NULL) {
+        snprintf(out, size, "%s.%s", file, instance);
+    } else {
+        snprintf(out, size, "%.*s.%s%s", (int)(ext - file), file, instance, ext);
+    }
+}
+
+int instance_port(void) {
+    if (instance[0] == '\0') {
+        return INSTANCE_BASE_PORT;
+    }
+
+    char *end;
+    long number = strtol(instance, &end, 10);
+    if (*end == '\0' && number >= 0 && number < INSTANCE_NUMBERED_PORTS) {
+        return INSTANCE_BASE_PORT + (int)number;
+    }
+
+    uint32_t hash = 2166136261u;
+    for (const char *c = instance; *c; c++) {
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    }
+    return INSTANCE_BASE_PORT + INSTANCE_NUMBERED_PORTS + (int)(hash % INSTANCE_HASHED_PORTS);
+}
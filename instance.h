@@ -0,0 +1,59 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include <stddef.h>
+
+/**
+ * Server Instance Namespace Header
+ *
+ * Lets several servers share one host. An instance name, from -i or the
+ * MONOPOLY_INSTANCE environment variable, is folded into every IPC object
+ * name (room and scheduler segments, board versions, log queue and
+ * semaphore), into the names of the files a server writes in its working
+ * directory (game.log, scores.txt), and picks the TCP port clients use.
+ *
+ * Without an instance every name and the port are what they always were
+ * ("/monopoly_game_shm", port 8080). Instance "blue" uses
+ * "/monopoly.blue_game_shm", game.blue.log and its own port. A numeric
+ * instance N listens on 8080 + N; other names hash into a port range
+ * above that.
+ */
+
+#define INSTANCE_ENV "MONOPOLY_INSTANCE"
+#define INSTANCE_NAME_MAX 32
+#define INSTANCE_BASE_PORT 8080
+#define INSTANCE_NUMBERED_PORTS 1000   // Instances "0".."999" map straight onto ports
+#define INSTANCE_HASHED_PORTS 1000     // Named instances hash into the next 1000 ports
+
+/**
+ * Select the instance for this process (call before any IPC is created)
+ *
+ * @param name Instance name, or NULL to use $MONOPOLY_INSTANCE (unset or
+ *             empty = the default instance)
+ * @return 0 on success, -1 if the name is too long or not [A-Za-z0-9_-]
+ */
+int instance_init(const char *name);
+
+/**
+ * Current instance name ("" for the default instance)
+ */
+const char *instance_name(void);
+
+/**
+ * Name of an IPC object in this instance: "/monopoly_<base>" by default,
+ * "/monopoly.<instance>_<base>" otherwise
+ */
+void instance_ipc_name(char *out, size_t size, const char *base);
+
+/**
+ * Name of a working-directory file in this instance: the instance goes in
+ * before the extension ("game.log" becomes "game.<instance>.log")
+ */
+void instance_file_name(char *out, size_t size, const char *file);
+
+/**
+ * TCP port the instance's server listens on
+ */
+int instance_port(void);
+
+#endif // INSTANCE_H
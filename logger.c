@@ -1,4 +1,5 @@
 #include "logger.h"
+#include "instance.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <mqueue.h>
@@ -19,8 +20,8 @@
  */
 
 static const char *LOG_FILE_PATH = "game.log";
-static const char *LOG_MQ_NAME   = "/monopoly_log_mq";
-static const char *LOG_SEM_NAME  = "/monopoly_log_sem";
+static char LOG_MQ_NAME[64];             // "/monopoly_log_mq" in this instance
+static char LOG_SEM_NAME[64];            // "/monopoly_log_sem" in this instance
 static const long  LOG_MSG_SIZE  = 1024;
 static const long  LOG_MAX_MSGS  = 10;
 
@@ -103,6 +104,8 @@ int logger_init(const char *path) {
         return -1;
     }
 
+    instance_ipc_name(LOG_MQ_NAME, sizeof(LOG_MQ_NAME), "log_mq");
+    instance_ipc_name(LOG_SEM_NAME, sizeof(LOG_SEM_NAME), "log_sem");
     log_sem = sem_open(LOG_SEM_NAME, O_CREAT, 0666, 1);
     if (log_sem == SEM_FAILED) {
         fprintf(stderr, "[LOGGER] Warning: sem_open failed: %s\n", strerror(errno));
@@ -0,0 +1,356 @@
+#include "mcts.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MCTS_EXPLORATION 1.4
+#define MCTS_MAX_DEPTH 64           // Bot decisions tracked per iteration
+#define MCTS_CLOCK_CHECK_MASK 7     // Read the clock every 8 rollout turns
+#define MCTS_JOIN_SLACK_US 100      // Workers stop this early so waking and merging them fits the budget
+#define MCTS_TT_SIZE_LOG2 14        // Positions remembered per decision
+#define MCTS_TT_SCALE 1024          // Fixed-point scale of rewards in the table
+
+typedef struct {
+    uint32_t visits;
+    double value;                   // Sum of rewards seen through this node
+    int32_t child[2];               // [pass, buy]; -1 until expanded
+} MctsNode;
+
+struct MctsWorker {
+    MctsEngine *engine;
+    MctsNode *nodes;
+    int capacity;
+    int used;
+    unsigned int seed;
+
+    // Inputs and outputs of the current decision
+    const SimGame *root;
+    const SimMove *pending;
+    long long deadline_ns;
+    long iterations;
+    SimGame game;
+};
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int alloc_children(MctsWorker *w, int node) {
+    if (w->used + 2 > w->capacity) {
+        return -1;
+    }
+    for (int a = 0; a < 2; a++) {
+        MctsNode *child = &w->nodes[w->used];
+        child->visits = 0;
+        child->value = 0.0;
+        child->child[0] = child->child[1] = -1;
+        w->nodes[node].child[a] = w->used++;
+    }
+    return 0;
+}
+
+// UCB1 over the two actions; unvisited actions are tried first
+static int select_action(MctsWorker *w, int node) {
+    const MctsNode *n = &w->nodes[node];
+    const MctsNode *c0 = &w->nodes[n->child[0]];
+    const MctsNode *c1 = &w->nodes[n->child[1]];
+
+    if (c0->visits == 0 || c1->visits == 0) {
+        if (c0->visits == 0 && c1->visits == 0) {
+            return rand_r(&w->seed) & 1;
+        }
+        return c0->visits == 0 ? 0 : 1;
+    }
+
+    double log_n = log((double)n->visits);
+    double u0 = c0->value / c0->visits + MCTS_EXPLORATION * sqrt(log_n / c0->visits);
+    double u1 = c1->value / c1->visits + MCTS_EXPLORATION * sqrt(log_n / c1->visits);
+    return u1 > u0 ? 1 : 0;
+}
+
+static double score_rollout(const SimGame *game, int me) {
+    const PackedGameState *s = &game->state;
+    if (!packed_is_alive(s, me)) {
+        return 0.0;
+    }
+    if (s->status == GAME_OVER) {
+        return 1.0;
+    }
+
+    // Unfinished game: share of the table's net worth still standing
+    double mine = sim_net_worth(game, me);
+    double total = 0.0;
+    for (int p = 0; p < s->num_players; p++) {
+        if (packed_is_alive(s, p)) {
+            total += sim_net_worth(game, p);
+        }
+    }
+    return total > 0.0 ? mine / total : 0.0;
+}
+
+// Start a freshly expanded node from the totals other paths have already
+// gathered for the position it reached
+static void seed_from_table(MctsWorker *w, int node, uint64_t key) {
+    uint64_t data;
+    if (tt_probe(&w->engine->tt, key, &data)) {
+        w->nodes[node].visits = tt_visits(data);
+        w->nodes[node].value = (double)tt_score(data) / MCTS_TT_SCALE;
+    }
+}
+
+// Add one rollout to a position's totals. Concurrent updates from other
+// workers may be lost; the table only ever informs, never decides.
+static void record_in_table(MctsWorker *w, uint64_t key, double reward) {
+    uint64_t data;
+    uint32_t visits = 0;
+    int32_t score = 0;
+    if (tt_probe(&w->engine->tt, key, &data)) {
+        visits = tt_visits(data);
+        score = tt_score(data);
+    }
+    tt_store(&w->engine->tt, key,
+             tt_pack(visits + 1, score + (int32_t)(reward * MCTS_TT_SCALE)));
+}
+
+// One selection, expansion, rollout and backpropagation. Returns 0, or -1
+// if the deadline passed mid-rollout (nothing is backpropagated).
+static int run_iteration(MctsWorker *w) {
+    const MctsEngine *engine = w->engine;
+    SimGame *game = &w->game;
+    int me = w->pending->player_id;
+    int path[MCTS_MAX_DEPTH + 2];
+    int depth = 0;
+    int leaf = -1;                  // Node expanded this iteration
+    uint64_t leaf_key = 0;
+
+    sim_reset(game, &w->root->state);
+    sim_redeal_cards(game);
+
+    // Root decision is always in the tree
+    SimMove move = *w->pending;
+    int action = select_action(w, 0);
+    path[depth++] = 0;
+    int cur = w->nodes[0].child[action];
+    path[depth++] = cur;
+    sim_commit(game, &move, action, engine->policies);
+
+    int in_tree = 1;
+    for (int turn = 0; turn < engine->config.horizon_turns &&
+                       game->state.status != GAME_OVER; turn++) {
+        if ((turn & MCTS_CLOCK_CHECK_MASK) == 0 && now_ns() >= w->deadline_ns) {
+            return -1;
+        }
+        sim_build(game, &engine->policy);
+        if (!sim_roll(game, &move)) {
+            sim_commit(game, &move, 0, engine->policies);
+            continue;
+        }
+
+        int buy;
+        int expanded = 0;
+        if (move.player_id == me && in_tree && depth < MCTS_MAX_DEPTH) {
+            if (w->nodes[cur].child[0] < 0) {
+                // Expand one level per iteration, then roll out
+                in_tree = 0;
+                if (alloc_children(w, cur) == 0) {
+                    buy = rand_r(&w->seed) & 1;
+                    cur = w->nodes[cur].child[buy];
+                    path[depth++] = cur;
+                    leaf = cur;
+                    expanded = 1;
+                } else {
+                    buy = bot_policy_wants(&engine->policy, &game->board->tiles[move.new_position],
+                                           move.new_position, game->state.money[me]);
+                }
+            } else {
+                buy = select_action(w, cur);
+                cur = w->nodes[cur].child[buy];
+                path[depth++] = cur;
+            }
+        } else {
+            buy = bot_policy_wants(&engine->policy, &game->board->tiles[move.new_position],
+                                   move.new_position, game->state.money[move.player_id]);
+        }
+        sim_commit(game, &move, buy, engine->policies);
+        if (expanded) {
+            leaf_key = game->hash;
+            seed_from_table(w, leaf, leaf_key);
+        }
+    }
+
+    double reward = score_rollout(game, me);
+    for (int i = 0; i < depth; i++) {
+        w->nodes[path[i]].visits++;
+        w->nodes[path[i]].value += reward;
+    }
+    if (leaf >= 0) {
+        record_in_table(w, leaf_key, reward);
+    }
+    return 0;
+}
+
+static void worker_search(void *arg) {
+    MctsWorker *w = (MctsWorker *)arg;
+
+    w->used = 1;
+    w->nodes[0].visits = 0;
+    w->nodes[0].value = 0.0;
+    w->nodes[0].child[0] = w->nodes[0].child[1] = -1;
+    w->iterations = 0;
+    if (alloc_children(w, 0) != 0) {
+        return;
+    }
+    sim_copy_board(&w->game, w->root);
+
+    // Stop at the deadline (checked inside rollouts too) or once the node
+    // arena is full
+    while (w->used + 2 <= w->capacity && now_ns() < w->deadline_ns) {
+        if (run_iteration(w) != 0) {
+            break;
+        }
+        w->iterations++;
+    }
+}
+
+void mcts_default_config(MctsConfig *config) {
+    config->threads = 2;
+    config->max_nodes = 4096;
+    config->time_budget_us = 2000;
+    config->horizon_turns = 80;
+}
+
+MctsEngine *mcts_create(const MctsConfig *config, const BotPolicy *policy) {
+    MctsEngine *engine = calloc(1, sizeof(MctsEngine));
+    if (engine == NULL) {
+        fprintf(stderr, "[MCTS] Error: out of memory\n");
+        return NULL;
+    }
+
+    if (config != NULL) {
+        engine->config = *config;
+    } else {
+        mcts_default_config(&engine->config);
+    }
+    if (policy != NULL) {
+        engine->policy = *policy;
+    } else {
+        bot_policy_default(&engine->policy);
+    }
+    for (int p = 0; p < PACKED_MAX_SEATS; p++) {
+        engine->policies[p] = &engine->policy;
+    }
+
+    int threads = engine->config.threads;
+    int per_worker = engine->config.max_nodes / (threads > 0 ? threads : 1);
+    if (threads < 1 || threads > POOL_MAX_THREADS || per_worker < 3) {
+        fprintf(stderr, "[MCTS] Error: need 1-%d threads and at least 3 nodes per thread\n",
+                POOL_MAX_THREADS);
+        free(engine);
+        return NULL;
+    }
+
+    engine->workers = calloc((size_t)threads, sizeof(MctsWorker));
+    engine->pool = pool_create(threads, 0);
+    if (engine->workers == NULL || engine->pool == NULL ||
+        tt_init(&engine->tt, MCTS_TT_SIZE_LOG2) != 0) {
+        mcts_destroy(engine);
+        return NULL;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        MctsWorker *w = &engine->workers[i];
+        w->engine = engine;
+        w->capacity = per_worker;
+        w->seed = (unsigned int)now_ns() ^ (unsigned int)(i * 0x9e3779b9u);
+        w->nodes = malloc((size_t)per_worker * sizeof(MctsNode));
+        if (w->nodes == NULL) {
+            fprintf(stderr, "[MCTS] Error: out of memory for node arena\n");
+            mcts_destroy(engine);
+            return NULL;
+        }
+    }
+
+    return engine;
+}
+
+void mcts_destroy(MctsEngine *engine) {
+    if (engine == NULL) {
+        return;
+    }
+    pool_destroy(engine->pool);
+    tt_free(&engine->tt);
+    if (engine->workers != NULL) {
+        for (int i = 0; i < engine->config.threads; i++) {
+            free(engine->workers[i].nodes);
+        }
+        free(engine->workers);
+    }
+    free(engine);
+}
+
+int mcts_decide_purchase(MctsEngine *engine, const SimGame *root, const SimMove *pending,
+                         MctsStats *stats) {
+    long long start = now_ns();
+    long long deadline = start + (engine->config.time_budget_us - MCTS_JOIN_SLACK_US) * 1000LL;
+    int threads = engine->config.threads;
+
+    // Totals from the previous decision were scored for another root
+    tt_clear(&engine->tt);
+    for (int i = 0; i < threads; i++) {
+        MctsWorker *w = &engine->workers[i];
+        w->root = root;
+        w->pending = pending;
+        w->deadline_ns = deadline;
+        w->game.seed = rand_r(&w->seed);
+        if (pool_submit(engine->pool, worker_search, w) != 0) {
+            worker_search(w);
+        }
+    }
+    pool_wait(engine->pool);
+
+    // Merge root statistics from every worker's tree
+    uint32_t visits[2] = {0, 0};
+    double value[2] = {0.0, 0.0};
+    long iterations = 0;
+    int nodes = 0;
+    for (int i = 0; i < threads; i++) {
+        MctsWorker *w = &engine->workers[i];
+        iterations += w->iterations;
+        nodes += w->used;
+        if (w->nodes[0].child[0] < 0) {
+            continue;
+        }
+        for (int a = 0; a < 2; a++) {
+            const MctsNode *c = &w->nodes[w->nodes[0].child[a]];
+            visits[a] += c->visits;
+            value[a] += c->value;
+        }
+    }
+
+    int buy;
+    if (visits[0] == 0 || visits[1] == 0) {
+        // Out of budget before both actions were tried: fall back to the policy
+        const PackedGameState *s = &root->state;
+        buy = bot_policy_wants(&engine->policy, &root->board->tiles[pending->new_position],
+                               pending->new_position, s->money[pending->player_id]);
+    } else if (visits[1] != visits[0]) {
+        buy = visits[1] > visits[0];
+    } else {
+        buy = value[1] / visits[1] >= value[0] / visits[0];
+    }
+
+    if (stats != NULL) {
+        stats->iterations = iterations;
+        stats->nodes = nodes;
+        stats->elapsed_us = (long)((now_ns() - start) / 1000);
+        for (int a = 0; a < 2; a++) {
+            stats->visits[a] = visits[a];
+            stats->value[a] = visits[a] > 0 ? value[a] / visits[a] : 0.0;
+        }
+    }
+    return buy;
+}
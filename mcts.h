@@ -0,0 +1,84 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <stdint.h>
+#include "simulation.h"
+#include "thread_pool.h"
+#include "transposition.h"
+
+/**
+ * Monte Carlo Tree Search Bot Header
+ *
+ * Decides buy/pass for an automated seat using open-loop UCT: tree nodes
+ * are the bot's own purchase decisions, dice and opponents are sampled
+ * from the simulator, and every seat builds, bids and (opponents) buys
+ * by the rollout BotPolicy.
+ *
+ * Each worker thread grows its own tree (root parallelisation) and the
+ * root statistics are merged when the budget runs out. Every decision is
+ * capped by both a wall-clock deadline and a tree node budget.
+ *
+ * Newly expanded nodes are keyed by the Zobrist hash of the position they
+ * reach. A transposition table shared by the workers keeps rollout totals
+ * per position, so a node reached through another move order (or in
+ * another worker's tree) starts from what is already known about it.
+ */
+
+typedef struct {
+    int threads;             // Rollout workers (1 to POOL_MAX_THREADS)
+    int max_nodes;           // Tree nodes per decision, split between workers
+    long time_budget_us;     // Hard wall-clock limit per decision
+    int horizon_turns;       // Rollout length before scoring by net worth
+} MctsConfig;
+
+typedef struct {
+    long iterations;         // Rollouts completed
+    int nodes;               // Tree nodes allocated
+    long elapsed_us;         // Wall-clock time spent
+    uint32_t visits[2];      // Root visits for [pass, buy]
+    double value[2];         // Mean reward for [pass, buy]
+} MctsStats;
+
+typedef struct MctsWorker MctsWorker;
+
+typedef struct {
+    MctsConfig config;
+    BotPolicy policy;        // Rollout policy for every seat
+    const BotPolicy *policies[PACKED_MAX_SEATS];    // &policy per seat, for sim_commit()
+    ThreadPool *pool;
+    MctsWorker *workers;
+    TranspositionTable tt;   // Rollout totals per position, cleared per decision
+} MctsEngine;
+
+/**
+ * Fill a config with defaults sized for a few milliseconds per decision
+ */
+void mcts_default_config(MctsConfig *config);
+
+/**
+ * Create a search engine (allocates the worker pool and node arenas)
+ *
+ * @param config Budget and threading; NULL for defaults
+ * @param policy Rollout policy; NULL for bot_policy_default()
+ * @return Engine pointer, or NULL on failure
+ */
+MctsEngine *mcts_create(const MctsConfig *config, const BotPolicy *policy);
+
+/**
+ * Destroy an engine and its worker pool
+ */
+void mcts_destroy(MctsEngine *engine);
+
+/**
+ * Decide whether the seat to move should buy the tile offered by `pending`
+ *
+ * @param engine Search engine
+ * @param root Simulation positioned before `pending` is committed
+ * @param pending Rolled move from sim_roll() that offers a purchase
+ * @param stats Optional search statistics (may be NULL)
+ * @return 1 to buy, 0 to pass
+ */
+int mcts_decide_purchase(MctsEngine *engine, const SimGame *root, const SimMove *pending,
+                         MctsStats *stats);
+
+#endif // MCTS_H
@@ -0,0 +1,121 @@
+#include "packed_state.h"
+#include <string.h>
+
+// Encode the live fields of a GameState
+int pack_game_state(const GameState *state, PackedGameState *out) {
+    if (state->num_players < 0 || state->num_players > PACKED_MAX_SEATS ||
+        state->board_size < 1 || state->board_size > PACKED_MAX_TILES) {
+        return -1;
+    }
+
+    memset(out, 0, sizeof(PackedGameState));
+    out->num_players = (uint8_t)state->num_players;
+    out->active_player_count = (uint8_t)alive_count(state);
+    out->current_turn = (uint8_t)state->current_turn;
+    out->board_size = (uint8_t)state->board_size;
+    out->status = (uint8_t)state->game_state;
+    out->round = (uint32_t)state->round;
+
+    for (int i = 0; i < state->num_players; i++) {
+        const Player *p = &state->players[i];
+        if (p->position < 0 || p->position >= state->board_size) {
+            return -1;
+        }
+        packed_set_position(out, i, p->position);
+        out->money[i] = p->money;
+        if (p->is_active) {
+            out->active_mask |= (uint8_t)(1u << i);
+        }
+        if (p->is_bankrupt) {
+            out->bankrupt_mask |= (uint8_t)(1u << i);
+        }
+    }
+
+    for (int t = 0; t < state->board_size; t++) {
+        int owner = state->board_owner[t];
+        if (owner < -1 || owner >= PACKED_MAX_SEATS) {
+            return -1;
+        }
+        packed_set_owner(out, t, owner);
+        out->buildings[t] = state->buildings[t];
+    }
+
+    memcpy(out->decks, state->decks, sizeof(out->decks));
+    return 0;
+}
+
+// Write the live fields back into a GameState
+void unpack_game_state(const PackedGameState *packed, GameState *state) {
+    state->num_players = packed->num_players;
+    state->alive_mask = (SeatMask)(packed->active_mask & ~packed->bankrupt_mask);
+    state->current_turn = packed->current_turn;
+    state->game_state = (GameStatus)packed->status;
+    state->round = (int)packed->round;
+
+    for (int i = 0; i < packed->num_players; i++) {
+        Player *p = &state->players[i];
+        p->position = packed_get_position(packed, i);
+        p->money = packed->money[i];
+        p->is_active = (packed->active_mask >> i) & 1;
+        p->is_bankrupt = (packed->bankrupt_mask >> i) & 1;
+    }
+
+    for (int t = 0; t < packed->board_size; t++) {
+        state->board_owner[t] = packed_get_owner(packed, t);
+        state->buildings[t] = packed->buildings[t];
+    }
+
+    memcpy(state->decks, packed->decks, sizeof(state->decks));
+}
+
+// Commit a landing result (same rules as the server's commit step)
+void packed_apply_landing(PackedGameState *s, int player_id, const LandingResult *landing) {
+    int pos = landing->new_position;
+    packed_set_position(s, player_id, pos);
+    s->money[player_id] += landing->money_change;
+
+    if (landing->property_bought) {
+        packed_set_owner(s, pos, player_id);
+    }
+
+    if (landing->owner_id != -1 && landing->owner_id != player_id) {
+        s->money[landing->owner_id] += -landing->money_change;
+    }
+
+    if (landing->collect_amount > 0) {
+        for (int p = 0; p < s->num_players; p++) {
+            if (p == player_id || !packed_is_alive(s, p)) {
+                continue;
+            }
+            s->money[p] -= landing->collect_amount;
+            s->money[player_id] += landing->collect_amount;
+            if (is_player_bankrupt(s->money[p])) {
+                s->bankrupt_mask |= (uint8_t)(1u << p);
+                s->active_player_count--;
+                packed_release(s, p);
+            }
+        }
+    }
+
+    if (landing->is_bankrupt) {
+        s->bankrupt_mask |= (uint8_t)(1u << player_id);
+        s->active_player_count--;
+        packed_release(s, player_id);
+    }
+}
+
+// Advance to the next seat still in the game
+void packed_advance_turn(PackedGameState *s) {
+    SeatMask alive = (SeatMask)(s->active_mask & ~s->bankrupt_mask);
+    int next = seat_next(alive, s->current_turn);
+    if (next >= 0) {
+        if (next <= s->current_turn) {
+            s->round++;
+        }
+        s->current_turn = (uint8_t)next;
+    }
+
+    if (seat_count(alive) <= 1) {
+        s->status = GAME_OVER;
+    }
+}
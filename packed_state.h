@@ -0,0 +1,115 @@
+#ifndef PACKED_STATE_H
+#define PACKED_STATE_H
+
+#include <stdint.h>
+#include "game_state.h"
+#include "game_logic.h"
+
+// Compact encoding of the live part of a game (no names, scores or locks).
+// Used by simulators, search and snapshot storage so they can work on
+// dense arrays instead of full GameState copies. Only games within the
+// packed limits fit (the classic table sizes); larger party tables are
+// played without search (see pack_game_state).
+
+#define PACKED_MAX_SEATS 8
+#define PACKED_MAX_TILES 64
+#define PACKED_POS_BITS 6       // 0..63
+#define PACKED_OWNER_BITS 4     // 0 = bank, 1..8 = seat + 1
+#define PACKED_OWNERS_PER_WORD (64 / PACKED_OWNER_BITS)
+#define PACKED_OWNER_WORDS (PACKED_MAX_TILES / PACKED_OWNERS_PER_WORD)
+
+// Four cache lines: everything a turn touches lives in the first one,
+// the per-tile owner bitfield and card decks in the second, the per-seat
+// ownership bitboards (portfolio queries) in the third and building
+// levels in the fourth. The first two are full, so the bitboards and
+// levels get lines of their own rather than squeezing them into the
+// owner bitfield: releases, net worth and building checks stay single
+// word operations, and a whole position still copies as one 256-byte
+// block per rollout.
+typedef struct __attribute__((aligned(64))) {
+    uint64_t positions;                 // PACKED_POS_BITS per seat
+    int32_t money[PACKED_MAX_SEATS];
+    uint32_t round;
+    uint8_t num_players;
+    uint8_t active_player_count;
+    uint8_t current_turn;
+    uint8_t board_size;
+    uint8_t active_mask;                // bit i = players[i].is_active
+    uint8_t bankrupt_mask;              // bit i = players[i].is_bankrupt
+    uint8_t status;                     // GameStatus
+
+    uint64_t owners[PACKED_OWNER_WORDS] __attribute__((aligned(64)));
+    CardDeck decks[DECK_COUNT];
+
+    uint64_t owned[PACKED_MAX_SEATS] __attribute__((aligned(64)));  // bit t = seat owns tile t
+
+    uint8_t buildings[PACKED_MAX_TILES] __attribute__((aligned(64)));
+} PackedGameState;
+
+_Static_assert(sizeof(PackedGameState) == 256, "PackedGameState must stay four cache lines");
+
+static inline int packed_get_position(const PackedGameState *s, int seat) {
+    return (int)((s->positions >> (seat * PACKED_POS_BITS)) & ((1u << PACKED_POS_BITS) - 1));
+}
+
+static inline void packed_set_position(PackedGameState *s, int seat, int position) {
+    uint64_t shift = (uint64_t)seat * PACKED_POS_BITS;
+    uint64_t mask = (uint64_t)((1u << PACKED_POS_BITS) - 1) << shift;
+    s->positions = (s->positions & ~mask) | (((uint64_t)position << shift) & mask);
+}
+
+// Returns -1 for unowned tiles, otherwise the owning seat
+static inline int packed_get_owner(const PackedGameState *s, int tile) {
+    uint64_t word = s->owners[tile / PACKED_OWNERS_PER_WORD];
+    int shift = (tile % PACKED_OWNERS_PER_WORD) * PACKED_OWNER_BITS;
+    return (int)((word >> shift) & ((1u << PACKED_OWNER_BITS) - 1)) - 1;
+}
+
+static inline void packed_set_owner(PackedGameState *s, int tile, int owner) {
+    int old_owner = packed_get_owner(s, tile);
+    if (old_owner >= 0) {
+        s->owned[old_owner] &= ~(1ULL << tile);
+    }
+    if (owner >= 0) {
+        s->owned[owner] |= 1ULL << tile;
+    }
+
+    uint64_t *word = &s->owners[tile / PACKED_OWNERS_PER_WORD];
+    int shift = (tile % PACKED_OWNERS_PER_WORD) * PACKED_OWNER_BITS;
+    uint64_t mask = (uint64_t)((1u << PACKED_OWNER_BITS) - 1) << shift;
+    *word = (*word & ~mask) | ((uint64_t)(owner + 1) << shift);
+}
+
+// Return all of a seat's tiles (and their buildings) to the bank
+static inline void packed_release(PackedGameState *s, int seat) {
+    uint64_t owned = s->owned[seat];
+    while (owned) {
+        int tile = __builtin_ctzll(owned);
+        packed_set_owner(s, tile, -1);
+        s->buildings[tile] = 0;
+        owned &= owned - 1;
+    }
+}
+
+static inline int packed_is_alive(const PackedGameState *s, int seat) {
+    return ((s->active_mask & ~s->bankrupt_mask) >> seat) & 1;
+}
+
+// Encode the live fields of a GameState. Returns 0, or -1 if the game
+// does not fit the packed limits.
+int pack_game_state(const GameState *state, PackedGameState *out);
+
+// Write the live fields back into a GameState. The board, scores and
+// synchronization primitives are left untouched; rebuild tile_rent[] with
+// build_rent_table() and owned_bits[] with index_owners() afterwards.
+void unpack_game_state(const PackedGameState *packed, GameState *state);
+
+// Commit a landing result (player ends on landing->new_position),
+// mirroring what the server applies to shared memory
+void packed_apply_landing(PackedGameState *s, int player_id, const LandingResult *landing);
+
+// Move the turn to the next seat that is still in the game, counting
+// rounds and flagging GAME_OVER like advance_turn() does
+void packed_advance_turn(PackedGameState *s);
+
+#endif // PACKED_STATE_H
@@ -0,0 +1,373 @@
+#include "replay.h"
+#include "turn.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Per-process append descriptor for the room's recording, opened on first
+// use so forked children each get their own
+static int record_fd = -1;
+static char record_path[64];
+
+void replay_seed_game(GameState *state, unsigned int seed) {
+    init_decks(state, seed);
+}
+
+uint32_t replay_board_hash(const BoardDef *board) {
+    const unsigned char *bytes = (const unsigned char *)board;
+    size_t size = board_def_size(board->tile_count, board->group_count);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int replay_start(GameState *state, const BoardDef *board, const char *board_path) {
+    state->replay_path[0] = '\0';
+    if (mkdir(REPLAY_DIR, 0755) == -1 && errno != EEXIST) {
+        logger_log("Not recording: cannot create %s: %s", REPLAY_DIR, strerror(errno));
+        return -1;
+    }
+
+    char path[sizeof(state->replay_path)];
+    // One server runs many rooms: the seed tells games started in the same second apart
+    snprintf(path, sizeof(path), "%s/game-%ld-%d-%08x.mgr", REPLAY_DIR, (long)time(NULL), (int)getpid(),
+             state->card_seed);
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd == -1) {
+        logger_log("Not recording: cannot create %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = REPLAY_MAGIC;
+    header.version = REPLAY_VERSION;
+    header.seed = state->card_seed;
+    header.num_players = state->num_players;
+    header.start_money = state->start_money;
+    header.board_hash = replay_board_hash(board);
+    snprintf(header.board_name, sizeof(header.board_name), "%s", board->name);
+    snprintf(header.board_path, sizeof(header.board_path), "%s", board_path);
+    int ok = write(fd, &header, sizeof(header)) == sizeof(header);
+    close(fd);
+    if (!ok) {
+        logger_log("Not recording: cannot write %s", path);
+        unlink(path);
+        return -1;
+    }
+
+    memcpy(state->replay_path, path, sizeof(path));
+    logger_log("Recording game to %s (seed %u)", path, header.seed);
+    return 0;
+}
+
+void replay_record(const GameState *state, ReplayRecord record) {
+    if (state->replay_path[0] == '\0') {
+        return;
+    }
+    if (record_fd == -1 || strcmp(record_path, state->replay_path) != 0) {
+        if (record_fd != -1) {
+            close(record_fd);
+        }
+        memcpy(record_path, state->replay_path, sizeof(record_path));
+        record_fd = open(record_path, O_WRONLY | O_APPEND);
+        if (record_fd == -1) {
+            logger_log("Cannot append to %s: %s", record_path, strerror(errno));
+            return;
+        }
+    }
+
+    record.move = (uint32_t)state->move_count;
+    if (write(record_fd, &record, sizeof(record)) != sizeof(record)) {
+        logger_log("Short write to %s", record_path);
+    }
+}
+
+int replay_load(ReplayLog *log, const char *path) {
+    memset(log, 0, sizeof(*log));
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "[REPLAY] Error: cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    if (fread(&log->header, sizeof(log->header), 1, f) != 1 ||
+        log->header.magic != REPLAY_MAGIC || log->header.version != REPLAY_VERSION ||
+        log->header.num_players < 1 || log->header.num_players > MAX_PLAYERS) {
+        fprintf(stderr, "[REPLAY] Error: %s is not a version %d recording\n", path, REPLAY_VERSION);
+        fclose(f);
+        return -1;
+    }
+
+    size_t capacity = 0;
+    ReplayRecord record;
+    while (fread(&record, sizeof(record), 1, f) == 1) {
+        if (log->count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            ReplayRecord *grown = realloc(log->records, capacity * sizeof(ReplayRecord));
+            if (grown == NULL) {
+                fprintf(stderr, "[REPLAY] Error: out of memory reading %s\n", path);
+                replay_free(log);
+                fclose(f);
+                return -1;
+            }
+            log->records = grown;
+        }
+        log->records[log->count++] = record;
+    }
+    fclose(f);
+    return 0;
+}
+
+void replay_free(ReplayLog *log) {
+    free(log->records);
+    log->records = NULL;
+    log->count = 0;
+}
+
+const char *replay_kind_name(ReplayKind kind) {
+    static const char *names[REPLAY_KIND_COUNT] = {
+        "roll", "build", "bid", "auction end", "trade offer", "trade answer", "skip", "leave", "join"
+    };
+    return kind < REPLAY_KIND_COUNT ? names[kind] : "unknown";
+}
+
+// Count a mismatch once, even if a seek replays the record again
+static void diverged(Replayer *r) {
+    if (r->now.next < r->checked) {
+        return;
+    }
+    if (r->divergences++ == 0) {
+        r->first_divergence = (long)r->now.next;
+    }
+}
+
+// Save a frame to seek back to (`skip` = records it already includes)
+static void add_keyframe(Replayer *r, const ReplayFrame *frame, size_t skip) {
+    if (r->keyframe_count > 0 &&
+        r->keyframes[r->keyframe_count - 1].state.move_count >= frame->state.move_count) {
+        return;     // Already taken on an earlier pass
+    }
+    if (r->keyframe_count == r->keyframe_capacity) {
+        size_t capacity = r->keyframe_capacity ? r->keyframe_capacity * 2 : 16;
+        ReplayFrame *grown = realloc(r->keyframes, capacity * sizeof(ReplayFrame));
+        if (grown == NULL) {
+            return;     // Seeking just gets slower
+        }
+        r->keyframes = grown;
+        r->keyframe_capacity = capacity;
+    }
+    r->keyframes[r->keyframe_count] = *frame;
+    r->keyframes[r->keyframe_count].next += skip;
+    r->keyframe_count++;
+}
+
+// Pass the turn on, keeping a keyframe every keyframe_turns turns
+static void end_turn(Replayer *r) {
+    next_turn(&r->now.state);
+    r->now.pending_turn = 0;
+    if (r->now.state.move_count % r->keyframe_turns == 0) {
+        add_keyframe(r, &r->now, 1);    // Resume after the record being applied
+    }
+}
+
+// Copy a frame into place; the private trade_mutex is never copied live
+static void restore(Replayer *r, const ReplayFrame *frame) {
+    r->now = *frame;
+    pthread_mutex_init(&r->now.state.trade_mutex, NULL);
+}
+
+int replayer_init(Replayer *r, const ReplayLog *log, const BoardDef *board, int keyframe_turns) {
+    memset(r, 0, sizeof(*r));
+    if ((int)board->tile_count > MAX_BOARD_SIZE) {
+        fprintf(stderr, "[REPLAY] Error: board has too many tiles\n");
+        return -1;
+    }
+    r->log = log;
+    r->board = board;
+    r->keyframe_turns = keyframe_turns > 0 ? keyframe_turns : REPLAY_KEYFRAME_TURNS;
+    r->first_divergence = -1;
+    build_tile_dispatch(&r->dispatch, board);
+
+    // Same starting position seat_player() sets up
+    ReplayFrame start;
+    memset(&start, 0, sizeof(start));
+    GameState *state = &start.state;
+    init_board(state, board);
+    state->start_money = log->header.start_money;
+    state->num_players = log->header.num_players;
+    for (int i = 0; i < state->num_players; i++) {
+        state->players[i].money = state->start_money;
+        seat_join(state, i);
+    }
+    state->game_state = PLAYING;
+    state->win_pct_move = -1;
+    replay_seed_game(state, log->header.seed);
+    restore(r, &start);
+    add_keyframe(r, &start, 0);
+    return 0;
+}
+
+void replayer_destroy(Replayer *r) {
+    pthread_mutex_destroy(&r->now.state.trade_mutex);
+    free(r->keyframes);
+    r->keyframes = NULL;
+    r->keyframe_count = 0;
+}
+
+// Re-apply one record through the server's rule code
+static void apply(Replayer *r, const ReplayRecord *rec) {
+    GameState *state = &r->now.state;
+    const BoardDef *board = r->board;
+    int player = rec->player;
+    if (player >= MAX_PLAYERS || (player >= state->num_players && rec->kind != REPLAY_JOIN)) {
+        diverged(r);
+        return;
+    }
+
+    switch ((ReplayKind)rec->kind) {
+        case REPLAY_ROLL: {
+            if (state->current_turn != player || state->game_state != PLAYING) {
+                diverged(r);
+            }
+            int dice;
+            LandingResult landing = roll_turn(state, &r->dispatch, player, &dice);
+            if (landing.property_bought && !(rec->flags & REPLAY_FLAG_BOUGHT)) {
+                decline_purchase(&landing);
+            }
+            commit_landing(state, board, player, &landing);
+            if (dice != rec->a || landing.new_position != rec->b ||
+                state->players[player].money != rec->expect) {
+                diverged(r);
+            }
+            if (landing.for_auction && !state->players[player].is_bankrupt) {
+                auction_open(&state->auction, landing.new_position, player, auction_bidders(state), 0);
+                r->now.pending_turn = 1;
+            } else {
+                end_turn(r);
+            }
+            break;
+        }
+        case REPLAY_BUILD:
+            if (build_next_house(state, board, player) != rec->a) {
+                diverged(r);
+            }
+            break;
+        case REPLAY_BID: {
+            Auction *auction = &state->auction;
+            if (auction_submit(auction, auction->id, player, rec->a, state->players[player].money) != 0 ||
+                auction->bids[player] != rec->a) {
+                diverged(r);
+            }
+            break;
+        }
+        case REPLAY_AUCTION_END: {
+            int price = 0;
+            int winner = state->auction.open ? settle_auction(state, board, &price) : -1;
+            if (winner != rec->a || price != rec->b) {
+                diverged(r);
+            }
+            if (r->now.pending_turn) {
+                end_turn(r);
+            }
+            break;
+        }
+        case REPLAY_TRADE_OFFER: {
+            TradeOffer offer;
+            memset(&offer, 0, sizeof(offer));
+            offer.from = player;
+            offer.to = rec->a;
+            offer.cash = rec->b;
+            memcpy(offer.give, rec->give, sizeof(offer.give));
+            memcpy(offer.take, rec->take, sizeof(offer.take));
+            if (offer.to < 0 || offer.to >= MAX_PLAYERS ||
+                trade_propose(state, board, &offer) != TRADE_OK || offer.id != rec->ref) {
+                diverged(r);
+            }
+            break;
+        }
+        case REPLAY_TRADE_ANSWER: {
+            TradeOffer offer;
+            if (!trade_take(state, player, &offer) || offer.id != rec->ref) {
+                diverged(r);
+                break;
+            }
+            if (rec->flags & REPLAY_FLAG_ACCEPTED) {
+                if ((int)trade_commit(state, board, &offer) != rec->a) {
+                    diverged(r);
+                }
+            } else if (rec->a == TRADE_STALE && !trade_is_stale(state, &offer)) {
+                diverged(r);
+            }
+            break;
+        }
+        case REPLAY_SKIP:
+            end_turn(r);
+            break;
+        case REPLAY_LEAVE:
+            seat_leave(state, player);
+            if (rec->flags & REPLAY_FLAG_ADVANCED) {
+                end_turn(r);
+            }
+            break;
+        case REPLAY_JOIN:
+            if (player != state->num_players) {
+                diverged(r);
+                break;
+            }
+            state->num_players++;
+            state->players[player].money = state->start_money;
+            state->players[player].position = 0;
+            seat_join(state, player);
+            break;
+        default:
+            diverged(r);
+            break;
+    }
+}
+
+int replayer_step(Replayer *r) {
+    if (r->now.next >= r->log->count) {
+        return 0;
+    }
+
+    apply(r, &r->log->records[r->now.next]);
+    r->now.next++;
+    if (r->now.next > r->checked) {
+        r->checked = r->now.next;
+    }
+    return 1;
+}
+
+void replayer_run(Replayer *r) {
+    while (replayer_step(r)) {
+    }
+}
+
+long replayer_seek(Replayer *r, long move) {
+    // Go back to the latest keyframe at or before the target, unless the
+    // current position is already between it and the target
+    const ReplayFrame *from = r->keyframes;     // Keyframe 0 is the start of the game
+    for (size_t i = r->keyframe_count; i-- > 0;) {
+        if (r->keyframes[i].state.move_count <= move) {
+            from = &r->keyframes[i];
+            break;
+        }
+    }
+    long now = r->now.state.move_count;
+    if (now > move || from->state.move_count > now) {
+        restore(r, from);
+    }
+
+    while (r->now.state.move_count < move && replayer_step(r)) {
+    }
+    return r->now.state.move_count;
+}
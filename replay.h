@@ -0,0 +1,137 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_state.h"
+#include "game_logic.h"
+#include "trade.h"
+
+// Game recording and replay.
+// A game is recorded as its seed (which fixes every dice roll and card
+// shuffle) plus the ordered list of everything players chose or failed to
+// do: rolls and purchase decisions, builds, auction bids, trade offers and
+// answers, skipped turns and departures. Records are appended under
+// game_mutex, so file order is commit order.
+//
+// The replayer re-applies them through the same rule code on a private
+// GameState: no sockets, no scheduler, no sleeps. Keyframes taken every
+// few turns let it seek to any turn without replaying from the start, and
+// each record carries the outcome the server saw, so rule changes show up
+// as divergences.
+
+#define REPLAY_MAGIC 0x5052474du    // "MGRP"
+#define REPLAY_VERSION 2
+#define REPLAY_DIR "replays"
+#define REPLAY_KEYFRAME_TURNS 32    // Default turns between keyframes
+
+typedef enum {
+    REPLAY_ROLL,            // a = dice, b = position after; flags = bought; expect = money after
+    REPLAY_BUILD,           // a = tile built on
+    REPLAY_BID,             // a = sealed bid (0 = pass)
+    REPLAY_AUCTION_END,     // a = winner (-1 = none), b = price; flags = deadline hit
+    REPLAY_TRADE_OFFER,     // ref = trade id, a = to, b = cash, give/take = tiles
+    REPLAY_TRADE_ANSWER,    // ref = trade id; flags = accepted; a = commit status if accepted,
+                            // TRADE_STALE if dropped as stale, TRADE_OK if refused
+    REPLAY_SKIP,            // Turn passed without a roll (bankrupt or invalid action)
+    REPLAY_LEAVE,           // Player left (disconnect, timeout); flags = turn passed
+    REPLAY_JOIN,            // Player took a seat after the game started
+    REPLAY_KIND_COUNT
+} ReplayKind;
+
+#define REPLAY_FLAG_BOUGHT 1u
+#define REPLAY_FLAG_TIMED_OUT 1u
+#define REPLAY_FLAG_ACCEPTED 1u
+#define REPLAY_FLAG_ADVANCED 1u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seed;              // Decks and dice both derive from it
+    int32_t num_players;        // Seated when the game started
+    int32_t start_money;
+    uint32_t board_hash;        // FNV-1a of the board blob the game was played on
+    char board_name[32];
+    char board_path[200];
+} ReplayHeader;
+
+typedef struct {
+    uint32_t move;              // Room's move_count when it happened
+    uint8_t kind;               // ReplayKind
+    uint8_t player;
+    uint16_t flags;
+    uint32_t ref;
+    int32_t a;
+    int32_t b;
+    int32_t expect;
+    uint16_t give[TRADE_MAX_TILES];
+    uint16_t take[TRADE_MAX_TILES];
+} ReplayRecord;
+
+_Static_assert(sizeof(ReplayHeader) == 256, "replay header layout is part of the file format");
+_Static_assert(sizeof(ReplayRecord) == 40, "replay record layout is part of the file format");
+
+// Seed used for a new game (decks and dice)
+void replay_seed_game(GameState *state, unsigned int seed);
+
+// Hash of a board blob, to tell whether a replay runs on the board it was recorded on
+uint32_t replay_board_hash(const BoardDef *board);
+
+// Start recording the room's game into REPLAY_DIR (caller holds game_mutex,
+// game just started). Returns 0, or -1 if recording is off for this game.
+int replay_start(GameState *state, const BoardDef *board, const char *board_path);
+
+// Append one record (caller holds game_mutex); no-op when not recording
+void replay_record(const GameState *state, ReplayRecord record);
+
+// A recorded game read back from disk
+typedef struct {
+    ReplayHeader header;
+    ReplayRecord *records;
+    size_t count;
+} ReplayLog;
+
+const char *replay_kind_name(ReplayKind kind);
+
+// Read / free a recording. replay_load returns 0, or -1 on error.
+int replay_load(ReplayLog *log, const char *path);
+void replay_free(ReplayLog *log);
+
+typedef struct {
+    GameState state;
+    size_t next;                        // Next record to apply
+    TradeOffer offers[MAX_PLAYERS];     // Last offer made to each seat
+    int pending_turn;                   // 1 while an auction holds the turn open
+} ReplayFrame;
+
+typedef struct {
+    const ReplayLog *log;
+    const BoardDef *board;
+    TileDispatch dispatch;
+    ReplayFrame now;
+    ReplayFrame *keyframes;             // keyframes[0] is the start of the game
+    size_t keyframe_count;
+    size_t keyframe_capacity;
+    int keyframe_turns;
+    size_t checked;                     // Records already compared against the recording
+    long divergences;                   // Records whose outcome differs from the recording
+    long first_divergence;              // Record index, -1 if none
+} Replayer;
+
+// Set up a replay of `log` on `board` at the start of the game.
+// Returns 0, or -1 on error.
+int replayer_init(Replayer *r, const ReplayLog *log, const BoardDef *board, int keyframe_turns);
+void replayer_destroy(Replayer *r);
+
+// Apply the next record. Returns 1 if one was applied, 0 at the end.
+int replayer_step(Replayer *r);
+
+// Replay to the end of the recording
+void replayer_run(Replayer *r);
+
+// Move to the position right after turn `move` was committed (or the end of
+// the game, if it is shorter), going back to a keyframe when needed.
+// Returns the turn reached.
+long replayer_seek(Replayer *r, long move);
+
+#endif // REPLAY_H
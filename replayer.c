@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "replay.h"
+
+/**
+ * Game replayer
+ *
+ * Rebuilds every intermediate GameState of recorded games (replays/game-*.mgr)
+ * at full CPU speed, through the same rule code the server runs:
+ *
+ *   ./monopoly_replay replays/game-1760000000-4242-5f3a9c21.mgr
+ *   ./monopoly_replay -t 120 replays/game-1760000000-4242-5f3a9c21.mgr
+ *
+ * Each record carries the outcome the server saw (dice, landing square,
+ * cash, auction winner, trade result); any record whose replay disagrees
+ * is a divergence, and the exit status is 1 if a game diverged. Replaying
+ * archived games after a rule or board change shows exactly which games
+ * it would have played differently. -t seeks to a turn (from the nearest
+ * keyframe) and prints the table there.
+ */
+
+static double elapsed_sec(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-B board] [-t turn] [-k keyframe_turns] [-q] recording...\n", prog);
+}
+
+static void print_table(const GameState *state, const BoardDef *board) {
+    if (state->game_state == GAME_OVER) {
+        printf("  turn %ld, round %d: game over, P%d won\n", state->move_count, state->round,
+               get_winner((GameState *)state));
+    } else {
+        printf("  turn %ld, round %d: P%d to play\n", state->move_count, state->round,
+               state->current_turn);
+    }
+    for (int p = 0; p < state->num_players; p++) {
+        const Player *player = &state->players[p];
+        printf("  P%d %-9s $%-6d on %-20s %d tiles ($%d)\n", p,
+               player->is_bankrupt ? "bankrupt" : player->is_active ? "" : "left",
+               player->money, board->tiles[player->position].name,
+               portfolio_count(state, p), portfolio_value(state, board, p));
+    }
+}
+
+// Replay one recording; returns its divergence count, or -1 on error
+static long replay_file(const char *path, const char *board_file, long turn, int keyframe_turns,
+                        int quiet) {
+    ReplayLog log;
+    if (replay_load(&log, path) != 0) {
+        return -1;
+    }
+
+    const char *board_path = board_file ? board_file : log.header.board_path;
+    const BoardDef *board = board_load(board_path);
+    if (board == NULL) {
+        replay_free(&log);
+        return -1;
+    }
+    int same_board = replay_board_hash(board) == log.header.board_hash;
+
+    Replayer *r = malloc(sizeof(Replayer));
+    if (r == NULL || replayer_init(r, &log, board, keyframe_turns) != 0) {
+        free(r);
+        board_close(board);
+        replay_free(&log);
+        return -1;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    replayer_run(r);
+    double secs = elapsed_sec(&start);
+    long turns = r->now.state.move_count;
+
+    printf("%s: %s%s, seed %u, %d players, %zu records, %ld turns in %.2fms (%.0f turns/s), "
+           "%ld divergences\n",
+           path, log.header.board_name, same_board ? "" : " (board changed)", log.header.seed,
+           log.header.num_players, log.count, turns, secs * 1e3, secs > 0 ? turns / secs : 0.0,
+           r->divergences);
+    if (r->first_divergence >= 0) {
+        const ReplayRecord *rec = &log.records[r->first_divergence];
+        printf("  first divergence: record %ld, turn %u, %s by P%d\n", r->first_divergence,
+               rec->move, replay_kind_name((ReplayKind)rec->kind), rec->player);
+    }
+
+    if (turn >= 0) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        long reached = replayer_seek(r, turn);
+        printf("  seek to turn %ld: reached %ld in %.3fms (%zu keyframes)\n", turn, reached,
+               elapsed_sec(&start) * 1e3, r->keyframe_count);
+    }
+    if (!quiet) {
+        print_table(&r->now.state, board);
+    }
+
+    long divergences = r->divergences;
+    replayer_destroy(r);
+    free(r);
+    board_close(board);
+    replay_free(&log);
+    return divergences;
+}
+
+int main(int argc, char *argv[]) {
+    const char *board_file = NULL;
+    long turn = -1;
+    int keyframe_turns = REPLAY_KEYFRAME_TURNS;
+    int quiet = 0;
+
+    int c;
+    while ((c = getopt(argc, argv, "B:t:k:q")) != -1) {
+        switch (c) {
+            case 'B': board_file = optarg; break;
+            case 't': turn = atol(optarg); break;
+            case 'k': keyframe_turns = atoi(optarg); break;
+            case 'q': quiet = 1; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (optind >= argc || keyframe_turns < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int status = 0;
+    for (int i = optind; i < argc; i++) {
+        long divergences = replay_file(argv[i], board_file, turn, keyframe_turns, quiet);
+        if (divergences != 0) {
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -1,6 +1,9 @@
 #include "scheduler.h"
 #include "sync.h"
 #include "logger.h"
+#include "instance.h"
+#include "shared_memory.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,11 +28,20 @@
 
 // Global shared memory pointers
 static SchedulerState *scheduler_state = NULL;
-static const char *SCHEDULER_SHM_NAME = "/monopoly_scheduler";
+static char scheduler_shm_name[64];     // "/monopoly_scheduler" in this instance
+static Segment scheduler_segment;
+
+#define SCHEDULER_LAYOUT ((uint32_t)(offsetof(SchedulerState, scheduler_lock) ^ \
+                                     offsetof(SchedulerState, turn_signal) << 12))
+
+static const SegmentPart scheduler_parts[1] = {
+    SEGMENT_PART(SchedulerState, SCHEDULER_LAYOUT)
+};
 
 /**
  * Find the next active and connected player
- * Skips disconnected players in round-robin way
+ * Skips disconnected players in round-robin way: one rotate and
+ * count-trailing-zeros over ready_mask, whatever the table size
  * 
  * @return Index of next active player, or -1 if none found
  */
@@ -38,21 +50,7 @@ static int find_next_active_player(void) {
         return -1;
     }
 
-    int start_idx = scheduler_state->current_player_idx;
-    int idx = (start_idx + 1) % scheduler_state->num_players;
-    int attempts = 0;
-
-    // Try to find an active player, maximum num_players attempts
-    while (attempts < scheduler_state->num_players) {
-        if (scheduler_state->players[idx].is_connected && 
-            scheduler_state->players[idx].is_active) {
-            return idx;
-        }
-        idx = (idx + 1) % scheduler_state->num_players;
-        attempts++;
-    }
-
-    return -1;  // No active players found
+    return seat_next(scheduler_state->ready_mask, scheduler_state->current_player_idx);
 }
 
 /**
@@ -102,35 +100,18 @@ int scheduler_init(int num_players) {
         return -1;
     }
 
-    // Create or open shared memory
-    int shm_fd = shm_open(SCHEDULER_SHM_NAME, O_CREAT | O_RDWR, 0666);
-    if (shm_fd == -1) {
-        fprintf(stderr, "[SCHEDULER] Error: shm_open failed: %s\n", strerror(errno));
+    // Create shared memory (a typed segment, backed as segment_set_paging says)
+    instance_ipc_name(scheduler_shm_name, sizeof(scheduler_shm_name), "scheduler");
+    if (segment_create(&scheduler_segment, scheduler_shm_name, scheduler_parts, 1) != 0) {
+        fprintf(stderr, "[SCHEDULER] Error: cannot create %s\n", scheduler_shm_name);
         return -1;
     }
+    scheduler_state = segment_part(&scheduler_segment, 0);
 
-    // Set size of shared memory
-    size_t size = sizeof(SchedulerState);
-    if (ftruncate(shm_fd, size) == -1) {
-        fprintf(stderr, "[SCHEDULER] Error: ftruncate failed: %s\n", strerror(errno));
-        close(shm_fd);
-        return -1;
-    }
-
-    // Map shared memory
-    scheduler_state = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    if (scheduler_state == MAP_FAILED) {
-        fprintf(stderr, "[SCHEDULER] Error: mmap failed: %s\n", strerror(errno));
-        close(shm_fd);
-        return -1;
-    }
-
-    close(shm_fd);
-
-    // Initialize scheduler state
-    memset(scheduler_state, 0, sizeof(SchedulerState));
+    // Initialize scheduler state (the segment starts zeroed)
     scheduler_state->num_players = num_players;
     scheduler_state->active_player_count = 0;
+    scheduler_state->ready_mask = 0;
     scheduler_state->current_player_idx = 0;
     scheduler_state->round_number = 0;
     scheduler_state->total_moves = 0;
@@ -140,7 +121,9 @@ int scheduler_init(int num_players) {
     if (logger_init("game.log") == -1) {
         fprintf(stderr, "[SCHEDULER] Warning: logger failed to initialize\n");
     } else {
-        logger_log("Scheduler initialized with %d players", num_players);
+        char mode[96];
+        segment_describe(&scheduler_segment, mode, sizeof(mode));
+        logger_log("Scheduler initialized with %d players (segment: %s)", num_players, mode);
     }
 
     // Initialize players
@@ -154,8 +137,8 @@ int scheduler_init(int num_players) {
         // Initialize per-player turn signal (start at 0)
         if (sync_sem_init(&scheduler_state->turn_signal[i], 0) == -1) {
             fprintf(stderr, "[SCHEDULER] Error: failed to init turn signal for player %d\n", i);
-            munmap(scheduler_state, size);
-            shm_unlink(SCHEDULER_SHM_NAME);
+            segment_destroy(&scheduler_segment, scheduler_shm_name);
+            scheduler_state = NULL;
             return -1;
         }
     }
@@ -163,15 +146,15 @@ int scheduler_init(int num_players) {
     // Initialize synchronization primitives
     if (sync_mutex_init(&scheduler_state->scheduler_lock) == -1) {
         fprintf(stderr, "[SCHEDULER] Error: failed to init scheduler_lock\n");
-        munmap(scheduler_state, size);
-        shm_unlink(SCHEDULER_SHM_NAME);
+        segment_destroy(&scheduler_segment, scheduler_shm_name);
+        scheduler_state = NULL;
         return -1;
     }
 
     if (sync_cond_init(&scheduler_state->turn_changed) == -1) {
         fprintf(stderr, "[SCHEDULER] Error: failed to init turn_changed condition\n");
-        munmap(scheduler_state, size);
-        shm_unlink(SCHEDULER_SHM_NAME);
+        segment_destroy(&scheduler_segment, scheduler_shm_name);
+        scheduler_state = NULL;
         return -1;
     }
 
@@ -220,6 +203,7 @@ int scheduler_player_connect(int player_id) {
 
     scheduler_state->players[player_id].is_connected = true;
     scheduler_state->players[player_id].is_active = true;
+    scheduler_state->ready_mask |= seat_bit(player_id);
     scheduler_state->active_player_count++;
 
     printf("[SCHEDULER] Player %d connected (active: %d)\n", 
@@ -253,6 +237,7 @@ int scheduler_player_disconnect(int player_id) {
 
     scheduler_state->players[player_id].is_connected = false;
     scheduler_state->players[player_id].is_active = false;
+    scheduler_state->ready_mask &= ~seat_bit(player_id);
     scheduler_state->active_player_count--;
 
     printf("[SCHEDULER] Player %d disconnected (active: %d)\n", 
@@ -406,19 +391,8 @@ int scheduler_cleanup(void) {
     sync_mutex_destroy(&scheduler_state->scheduler_lock);
     sync_cond_destroy(&scheduler_state->turn_changed);
 
-    // Unmap shared memory
-    size_t size = sizeof(SchedulerState);
-    if (munmap(scheduler_state, size) == -1) {
-        fprintf(stderr, "[SCHEDULER] Error: munmap failed: %s\n", strerror(errno));
-        return -1;
-    }
-
-    // Remove shared memory object
-    if (shm_unlink(SCHEDULER_SHM_NAME) == -1) {
-        fprintf(stderr, "[SCHEDULER] Error: shm_unlink failed: %s\n", strerror(errno));
-        return -1;
-    }
-
+    // Unmap and remove the segment
+    segment_destroy(&scheduler_segment, scheduler_shm_name);
     scheduler_state = NULL;
     printf("[SCHEDULER] Cleanup complete\n");
     logger_shutdown();
@@ -473,11 +447,12 @@ void *scheduler_thread_main(void *arg) {
         if (scheduler_state->game_in_progress && scheduler_state->active_player_count > 0) {
             int next_idx = find_next_active_player();
             if (next_idx >= 0) {
+                int wrapped = next_idx <= scheduler_state->current_player_idx;
                 scheduler_state->current_player_idx = next_idx;
                 scheduler_state->total_moves++;
 
-                // Check if we completed a full round
-                if (next_idx == 0) {
+                // Check if we completed a full round (the turn wrapped round the table)
+                if (wrapped) {
                     scheduler_state->round_number++;
                     printf("[SCHEDULER-THREAD] Round %d completed\n", scheduler_state->round_number);
                     logger_log("Round %d completed", scheduler_state->round_number);
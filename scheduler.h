@@ -4,9 +4,7 @@
 #include <pthread.h>
 #include <semaphore.h>
 #include <stdbool.h>
-
-#define MAX_PLAYERS 5
-#define MIN_PLAYERS 3
+#include "seats.h"
 
 typedef struct {
     int player_id;           // Unique player identifier (0 to num_players-1)
@@ -19,8 +17,9 @@ typedef struct {
 typedef struct {
     // Player information
     SchedulerPlayer players[MAX_PLAYERS];
-    int num_players;              // Current number of players (3-5)
+    int num_players;              // Seats at the table (MIN_PLAYERS to MAX_PLAYERS)
     int active_player_count;      // Number of currently active players
+    SeatMask ready_mask;          // Seats connected and active: the ones that get turns
     
     // Turn management
     int current_player_idx;       // Index of player whose turn it is (0 to num_players-1)
@@ -45,7 +44,7 @@ typedef struct {
  * Initializes all players as disconnected, sets up synchronization primitives,
  * and prepares for the first game.
  * 
- * @param num_players Number of players for this game (3-5)
+ * @param num_players Number of seats at the table (MIN_PLAYERS to MAX_PLAYERS)
  * @return 0 on success, -1 on failure
  */
 int scheduler_init(int num_players);
@@ -107,7 +106,7 @@ int scheduler_is_my_turn(int player_id);
 /**
  * Get the total number of players
  * 
- * @return Number of players (3-5)
+ * @return Number of seats (MIN_PLAYERS to MAX_PLAYERS)
  */
 int scheduler_get_num_players(void);
 
@@ -0,0 +1,42 @@
+#ifndef SEATS_H
+#define SEATS_H
+
+#include <stdint.h>
+
+// Table capacity and seat sets, shared by the rooms and the scheduler.
+// MAX_PLAYERS is the compile-time ceiling (one bit per seat in a
+// SeatMask); the server picks each table's size up to it at startup.
+
+#define MAX_PLAYERS 64
+#define MIN_PLAYERS 3
+
+typedef uint64_t SeatMask;      // bit i = seat i
+
+_Static_assert(MAX_PLAYERS <= 64, "seat masks hold one bit per seat");
+
+static inline SeatMask seat_bit(int seat) {
+    return (SeatMask)1 << seat;
+}
+
+static inline int seat_count(SeatMask seats) {
+    return __builtin_popcountll(seats);
+}
+
+// Lowest seat in the set, -1 if it is empty
+static inline int seat_first(SeatMask seats) {
+    return seats ? __builtin_ctzll(seats) : -1;
+}
+
+// First seat in the set after `seat`, wrapping around (`seat` itself if
+// it is the only one), -1 if the set is empty. Rotating the mask so the
+// seat after `seat` sits at bit 0 turns the search into one ctz.
+static inline int seat_next(SeatMask seats, int seat) {
+    if (!seats) {
+        return -1;
+    }
+    int shift = (seat + 1) & 63;
+    SeatMask rotated = seats >> shift | seats << ((64 - shift) & 63);
+    return (shift + __builtin_ctzll(rotated)) & 63;
+}
+
+#endif // SEATS_H
@@ -7,41 +7,80 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/mman.h>
+#include <sys/prctl.h>
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <pthread.h>
 #include <semaphore.h>
 #include <time.h>
 #include <stdint.h>
+#include <errno.h>
+#include <poll.h>
 #include "game_state.h"
 #include "logger.h"
 #include "scheduler.h"
 #include "game_logic.h"
+#include "simulation.h"
+#include "mcts.h"
+#include "estimator.h"
+#include "board_registry.h"
+#include "trade.h"
+#include "turn.h"
+#include "replay.h"
+#include "instance.h"
+#include "shared_memory.h"
 
-#define PORT 8080
-#define MAX_CLIENTS 5
-#define MIN_CLIENTS 3
+#define DEFAULT_TABLE_SEATS 5
+#define SEAT_NEXT_ROOM -2       // take_seat(): the seating room takes no more players
 
 // Global server state
 int server_fd;
-GameState *game_state = NULL;
+GameState *game_state = NULL;         // Seating room: new players join this one
+int num_bots = 0;                       // -b: bots seated at every new table
+int table_seats = DEFAULT_TABLE_SEATS;  // -n: seats per table (MIN_PLAYERS..MAX_PLAYERS)
+BoardRegistry *board_registry = NULL;   // Part of the room segment; versions are mapped by name
+const char *board_file = DEFAULT_BOARD_FILE;
+const char *room_file = NULL;           // -S: keep the room in this file across restarts
+volatile sig_atomic_t reload_requested = 0;
 pthread_t scheduler_thread_id;
+BotPolicy bot_policy;
+ThreadPool *estimator_pool = NULL;
+WinEstimator *win_estimator = NULL;
+pid_t server_pid;                       // Seat and bot children are forked from this process
 
 // Signal handler for graceful shutdown
 void sig_handler(int signo) {
+    // Children inherit this handler, but the pools, segments and socket it
+    // tears down belong to the server: a child just ends on Ctrl-C
+    if (getpid() != server_pid) {
+        if (signo == SIGINT) {
+            _exit(0);
+        }
+        return;
+    }
+    
     if (signo == SIGINT) {
         printf("\n[SERVER] Shutting down gracefully...\n");
-        save_scores(game_state);
+        save_scores();
         logger_log("Server shutdown requested");
+        
+        // Stop background estimation before its room is unmapped
+        estimator_stop(win_estimator);
+        pool_destroy(estimator_pool);
         logger_shutdown();
         
-        if (game_state) {
-            cleanup_game_state_memory(game_state);
-        }
+        // Version segments first: the registry lives in the room segment
+        board_registry_destroy(board_registry);
+        cleanup_room_slab();
         close(server_fd);
         exit(0);
     }
     
+    // Operator asked for the board file to be republished
+    if (signo == SIGHUP) {
+        reload_requested = 1;
+    }
+    
     // Reap zombie processes
     if (signo == SIGCHLD) {
         while (waitpid(-1, NULL, WNOHANG) > 0) {
@@ -50,27 +89,305 @@ void sig_handler(int signo) {
     }
 }
 
+// Read one tagged reply payload (a BidReply or TradeReply). Returns the
+// tag, or -1 if the client went away or sent something else.
+static int read_tagged_reply(int client_socket, uint32_t *reply_id, int32_t *value) {
+    char tag;
+    BidReply reply;
+    if (read(client_socket, &tag, 1) != 1 || (tag != AUCTION_BID_TAG && tag != TRADE_REPLY_TAG) ||
+        recv(client_socket, &reply, sizeof(reply), MSG_WAITALL) != sizeof(reply)) {
+        return -1;
+    }
+    *reply_id = reply.auction_id;
+    *value = reply.amount;
+    return tag;
+}
+
+// Wait for this client's answer to request `reply_id` until the deadline
+// (no lock held). Late replies to earlier requests are skipped; returns 0
+// (pass / refuse) on timeout.
+static int read_reply(int client_socket, char tag, uint32_t reply_id, const struct timespec *deadline) {
+    while (1) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        long wait_ms = (deadline->tv_sec - now.tv_sec) * 1000 +
+                       (deadline->tv_nsec - now.tv_nsec) / 1000000;
+        if (wait_ms <= 0) {
+            return 0;
+        }
+        
+        struct pollfd pfd = { client_socket, POLLIN, 0 };
+        int ready = poll(&pfd, 1, (int)wait_ms);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        
+        uint32_t id;
+        int32_t value;
+        int got = ready > 0 ? read_tagged_reply(client_socket, &id, &value) : -1;
+        if (got < 0) {
+            return 0;
+        }
+        if (got == tag && id == reply_id) {
+            return value;
+        }
+    }
+}
+
+// Read the next turn action, dropping replies that arrived after their
+// auction or trade offer closed
+static int read_action(int client_socket, char *action) {
+    int n;
+    while ((n = read(client_socket, action, 1)) == 1 &&
+           (*action == AUCTION_BID_TAG || *action == TRADE_REPLY_TAG)) {
+        BidReply late;
+        if (recv(client_socket, &late, sizeof(late), MSG_WAITALL) != sizeof(late)) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+// Post this seat's sealed bid for the open auction (caller holds game_mutex).
+// Humans are asked over their socket with game_mutex dropped; bots (no
+// socket) bid straight from the policy. Returns -1 if game_mutex was lost.
+static int place_bid(GameState *shm, const BoardDef *board, int player_id, int client_socket) {
+    Auction *auction = &shm->auction;
+    uint32_t id = auction_begin_bid(auction, player_id);
+    int tile = auction->tile;
+    const Property *prop = &board->tiles[tile];
+    int bid;
+    
+    if (client_socket < 0) {
+        bid = bot_policy_bid(&bot_policy, prop, tile, shm->players[player_id].money);
+    } else {
+        Packet pkt;
+        memset(&pkt, 0, sizeof(Packet));
+        pkt.type = MSG_AUCTION;
+        pkt.player_id = player_id;
+        pkt.position = tile;
+        pkt.money = shm->players[player_id].money;
+        pkt.reply_id = id;
+        snprintf(pkt.message, sizeof(pkt.message),
+                 "Auction: %s (list $%d). Enter a sealed bid within %ds, 0 to pass",
+                 prop->name, prop->price, AUCTION_SECONDS);
+        struct timespec deadline = auction->deadline;
+        
+        pthread_mutex_unlock(&shm->game_mutex);
+        bid = write(client_socket, &pkt, sizeof(Packet)) == sizeof(Packet)
+                  ? read_reply(client_socket, AUCTION_BID_TAG, id, &deadline) : 0;
+        if (lock_game_state(shm, player_id) < 0) {
+            return -1;
+        }
+    }
+    
+    if (auction_submit(auction, id, player_id, bid, shm->players[player_id].money) == 0) {
+        replay_record(shm, (ReplayRecord){ .kind = REPLAY_BID, .player = player_id,
+                                           .a = auction->bids[player_id] });
+        wake_seat(shm, auction->seller);
+    }
+    return 0;
+}
+
+// Describe a trade's tile list for a message ("Pasar Seni, Batu Caves")
+static void format_tiles(const BoardDef *board, const uint16_t tiles[], char *out, size_t size) {
+    size_t len = 0;
+    out[0] = '\0';
+    for (int i = 0; i < TRADE_MAX_TILES && tiles[i] != TILE_NONE && len < size; i++) {
+        int n = snprintf(out + len, size - len, "%s%s", len ? ", " : "", board->tiles[tiles[i]].name);
+        len += n > 0 ? (size_t)n : 0;
+    }
+}
+
+// Record the answer to a trade offer (a = TradeStatus, see replay.h)
+static void record_answer(GameState *shm, const TradeOffer *offer, int accepted, TradeStatus status) {
+    replay_record(shm, (ReplayRecord){ .kind = REPLAY_TRADE_ANSWER, .player = offer->to,
+                                       .flags = accepted ? REPLAY_FLAG_ACCEPTED : 0,
+                                       .ref = offer->id, .a = status });
+}
+
+// Answer the trade offer waiting for this seat (caller holds game_mutex).
+// Humans decide with game_mutex dropped; bots (no socket) ask the policy.
+// A stale offer is turned down from the version check alone. Returns -1
+// if game_mutex was lost.
+static int answer_trade(GameState *shm, const BoardDef *board, int player_id, int client_socket) {
+    TradeOffer offer;
+    if (!trade_take(shm, player_id, &offer)) {
+        return 0;
+    }
+    
+    int accept = 0;
+    if (trade_is_stale(shm, &offer)) {
+        logger_log("Trade #%u from Player %d to Player %d: stale", offer.id, offer.from, offer.to);
+        record_answer(shm, &offer, 0, TRADE_STALE);
+        return 0;
+    }
+    
+    if (client_socket < 0) {
+        accept = bot_policy_accepts(&bot_policy, board, &offer, shm->players[player_id].money);
+    } else {
+        char gets[80], gives[80];
+        format_tiles(board, offer.give, gets, sizeof(gets));
+        format_tiles(board, offer.take, gives, sizeof(gives));
+        
+        Packet pkt;
+        memset(&pkt, 0, sizeof(Packet));
+        pkt.type = MSG_TRADE;
+        pkt.player_id = player_id;
+        pkt.position = shm->players[player_id].position;
+        pkt.money = shm->players[player_id].money;
+        pkt.reply_id = offer.id;
+        snprintf(pkt.message, sizeof(pkt.message),
+                 "Player %d offers you [%s] + $%d for [%s] + $%d. Accept within %ds?",
+                 offer.from, gets, offer.cash > 0 ? offer.cash : 0,
+                 gives, offer.cash < 0 ? -offer.cash : 0, TRADE_SECONDS);
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += TRADE_SECONDS;
+        
+        pthread_mutex_unlock(&shm->game_mutex);
+        accept = write(client_socket, &pkt, sizeof(Packet)) == sizeof(Packet) &&
+                 read_reply(client_socket, TRADE_REPLY_TAG, offer.id, &deadline);
+        
+        // Something changed while they thought about it: no need to lock
+        if (accept && trade_is_stale(shm, &offer)) {
+            logger_log("Trade #%u from Player %d to Player %d: stale", offer.id, offer.from, offer.to);
+            if (lock_game_state(shm, player_id) < 0) {
+                return -1;
+            }
+            record_answer(shm, &offer, 0, TRADE_STALE);
+            return 0;
+        }
+        if (lock_game_state(shm, player_id) < 0) {
+            return -1;
+        }
+    }
+    
+    if (!accept) {
+        logger_log("Trade #%u from Player %d to Player %d: refused", offer.id, offer.from, offer.to);
+        record_answer(shm, &offer, 0, TRADE_OK);
+        return 0;
+    }
+    TradeStatus status = trade_commit(shm, board, &offer);
+    record_answer(shm, &offer, 1, status);
+    logger_log("Trade #%u from Player %d to Player %d: %s", offer.id, offer.from, offer.to,
+               trade_status_name(status));
+    return 0;
+}
+
+// Auction a tile the current player passed on (caller holds game_mutex).
+// Every seat still in bids at once; the seller waits with game_mutex
+// released until all bids are in or the deadline passes. Returns -1 if
+// game_mutex was lost.
+static int run_auction(GameState *shm, const BoardDef *board, int seller, int tile,
+                        int client_socket, char *outcome, size_t outcome_size) {
+    Auction *auction = &shm->auction;
+    auction_open(auction, tile, seller, auction_bidders(shm), AUCTION_SECONDS);
+    for (SeatMask bidders = auction->bidders & ~seat_bit(seller); bidders; bidders &= bidders - 1) {
+        wake_seat(shm, __builtin_ctzll(bidders));
+    }
+    if (auction_wants_bid(auction, seller) && place_bid(shm, board, seller, client_socket) < 0) {
+        return -1;
+    }
+    while (!auction_settled(auction)) {
+        int rc = wait_seat(shm, seller, &auction->deadline);
+        if (rc < 0) {
+            return -1;
+        }
+        if (rc == ETIMEDOUT) {
+            break;
+        }
+    }
+    
+    int price;
+    int timed_out = !auction_settled(auction);
+    int winner = settle_auction(shm, board, &price);
+    replay_record(shm, (ReplayRecord){ .kind = REPLAY_AUCTION_END, .player = seller,
+                                       .flags = timed_out ? REPLAY_FLAG_TIMED_OUT : 0,
+                                       .a = winner, .b = price });
+    const char *name = board->tiles[tile].name;
+    if (winner < 0) {
+        snprintf(outcome, outcome_size, " Auction of %s: no bids.", name);
+    } else {
+        snprintf(outcome, outcome_size, " Auction: Player %d bought %s for $%d.", winner, name, price);
+    }
+    return 0;
+}
+
+// Record a committed roll with the outcome the replayer must reproduce
+static void record_roll(GameState *shm, int player_id, int dice, const LandingResult *landing) {
+    replay_record(shm, (ReplayRecord){ .kind = REPLAY_ROLL, .player = player_id,
+                                       .flags = landing->property_bought ? REPLAY_FLAG_BOUGHT : 0,
+                                       .a = dice, .b = landing->new_position,
+                                       .expect = shm->players[player_id].money });
+}
+
+// Describe a committed landing in game.log (and in `text` for the player).
+// The only place landing text is built.
+static void log_landing(const BoardDef *board, int player_id, const LandingResult *landing,
+                        char *text, size_t size) {
+    format_landing(board, landing, text, size);
+    if (landing->money_change != 0) {
+        logger_log("Player %d: %s (money change: %d)", player_id, text, landing->money_change);
+    } else {
+        logger_log("Player %d: %s", player_id, text);
+    }
+}
+
+// Map the room's pinned board in this process once the game has started
+// (the seat's process keeps it mapped until it exits)
+static const BoardDef *load_room_board(GameState *shm, TileDispatch *dispatch) {
+    const BoardDef *board = board_registry_map(board_registry, shm->board_version);
+    if (board) {
+        build_tile_dispatch(dispatch, board);
+    }
+    return board;
+}
+
+// Drop the room's pin on its board version (caller holds game_mutex, game over)
+static void release_room_board(GameState *shm) {
+    if (shm->board_version != 0) {
+        board_registry_unpin(board_registry, shm->board_version);
+        state_write_begin(shm);
+        shm->board_version = 0;
+        state_write_end(shm);
+    }
+}
+
+// Take a seat out of the game (caller holds game_mutex)
+static void leave_game(GameState *shm, int player_id) {
+    seat_leave(shm, player_id);
+}
+
 // Handle individual client in child process
-void handle_client(int client_socket, int player_id) {
+void handle_client(int client_socket, RoomHandle room, int player_id) {
     Packet pkt;
     
-    logger_log("Player %d session started (PID: %d)", player_id, getpid());
+    logger_log("Player %d session started in room %u (PID: %d)", player_id, room.index, getpid());
     
-    // Attach to shared memory
-        GameState *shm = attach_game_state_memory();
+    // The slab is inherited; the seat's room reference was taken before fork
+    GameState *shm = room_get(room);
     if (!shm) {
-        logger_log("Player %d failed to attach shared memory", player_id);
+        logger_log("Player %d: room %u is gone", player_id, room.index);
         close(client_socket);
         exit(1);
     }
     
+    // Landing jump table for the room's pinned board (known once the game starts)
+    TileDispatch dispatch;
+    const BoardDef *board = NULL;
+    
     // Main game loop for this client
     while (1) {
         // Wait for turn
-        pthread_mutex_lock(&shm->game_mutex);
+        if (lock_game_state(shm, player_id) < 0) {
+            logger_log("Player %d lost the lock of room %u", player_id, room.index);
+            break;
+        }
         
         // Check if game is over
         if (shm->game_state == GAME_OVER) {
+            release_room_board(shm);
             int winner_id = get_winner(shm);
             if (winner_id == player_id) {
                 pkt.type = MSG_WIN;
@@ -91,9 +408,24 @@ void handle_client(int client_socket, int player_id) {
         }
         
         // Wait until game starts AND it's this player's turn
-        while ((shm->game_state != PLAYING || shm->current_turn != player_id) && 
+        int held = 1;
+        while (held && (shm->game_state != PLAYING || shm->current_turn != player_id) && 
                shm->game_state != GAME_OVER) {
-            pthread_cond_wait(&shm->turn_cond, &shm->game_mutex);
+            if (auction_wants_bid(&shm->auction, player_id) &&
+                (board || (board = load_room_board(shm, &dispatch)))) {
+                held = place_bid(shm, board, player_id, client_socket) == 0;
+                continue;
+            }
+            if (trade_waiting(shm, player_id) &&
+                (board || (board = load_room_board(shm, &dispatch)))) {
+                held = answer_trade(shm, board, player_id, client_socket) == 0;
+                continue;
+            }
+            held = wait_seat(shm, player_id, NULL) == 0;
+        }
+        if (!held) {
+            logger_log("Player %d lost the lock of room %u", player_id, room.index);
+            break;
         }
         
         // Check again if game ended while waiting
@@ -104,18 +436,29 @@ void handle_client(int client_socket, int player_id) {
         
         // Skip if player is bankrupt
         if (shm->players[player_id].is_bankrupt) {
+            replay_record(shm, (ReplayRecord){ .kind = REPLAY_SKIP, .player = player_id });
             advance_turn(shm);
-            pthread_cond_broadcast(&shm->turn_cond);
             pthread_mutex_unlock(&shm->game_mutex);
             continue;
         }
         
+        if (!board && !(board = load_room_board(shm, &dispatch))) {
+            logger_log("Player %d cannot map board version %u", player_id, shm->board_version);
+            leave_game(shm, player_id);
+            replay_record(shm, (ReplayRecord){ .kind = REPLAY_LEAVE, .player = player_id,
+                                               .flags = REPLAY_FLAG_ADVANCED });
+            advance_turn(shm);
+            pthread_mutex_unlock(&shm->game_mutex);
+            break;
+        }
+        
         // Send turn notification
         pkt.type = MSG_YOUR_TURN;
         pkt.player_id = player_id;
         pkt.position = shm->players[player_id].position;
         pkt.money = shm->players[player_id].money;
-        snprintf(pkt.message, sizeof(pkt.message), "Your turn! Press 'r' to roll dice.");
+        snprintf(pkt.message, sizeof(pkt.message),
+                 "Your turn! Press 'r' to roll dice, 'b' to build then roll, 't' to offer a trade.");
         pthread_mutex_unlock(&shm->game_mutex);
         
         if (write(client_socket, &pkt, sizeof(Packet)) < 0) {
@@ -125,17 +468,29 @@ void handle_client(int client_socket, int player_id) {
         
         // Wait for player action
         char action;
-        int n = read(client_socket, &action, 1);
+        int n = read_action(client_socket, &action);
         if (n <= 0) {
             logger_log("Player %d disconnected", player_id);
-            pthread_mutex_lock(&shm->game_mutex);
-            shm->players[player_id].is_active = 0;
-            shm->active_player_count--;
+            if (lock_game_state(shm, player_id) < 0) {
+                break;
+            }
+            leave_game(shm, player_id);
+            replay_record(shm, (ReplayRecord){ .kind = REPLAY_LEAVE, .player = player_id });
             pthread_mutex_unlock(&shm->game_mutex);
             break;
         }
         
-        pthread_mutex_lock(&shm->game_mutex);
+        // A trade proposal carries its terms; read them before taking the lock
+        TradeOffer offer;
+        if (action == TRADE_TAG &&
+            recv(client_socket, &offer, sizeof(offer), MSG_WAITALL) != sizeof(offer)) {
+            action = 0;
+        }
+        
+        if (lock_game_state(shm, player_id) < 0) {
+            logger_log("Player %d lost the lock of room %u", player_id, room.index);
+            break;
+        }
         
         // Initialize packet for response
         memset(&pkt, 0, sizeof(Packet));
@@ -143,71 +498,74 @@ void handle_client(int client_socket, int player_id) {
         pkt.position = shm->players[player_id].position;
         pkt.money = shm->players[player_id].money;
         
-        if (action == 'r' && !shm->players[player_id].is_bankrupt) {
-            // Server generates dice roll - use higher precision seed for each player
-            struct timespec ts;
-            clock_gettime(CLOCK_MONOTONIC, &ts);
-            unsigned int unique_seed = ts.tv_nsec + player_id * 12345 + (uintptr_t)&shm->players[player_id];
-            int dice = roll_dice_seeded(&unique_seed);
-            logger_log("Player %d rolled %d", player_id, dice);
-            
-            // Move player
-            shm->players[player_id].position = 
-                (shm->players[player_id].position + dice) % BOARD_SIZE;
-            
-            // Get landing result from game logic
-            int pos = shm->players[player_id].position;
-            LandingResult landing = handle_landing_on_position(pos, player_id, 
-                                                                shm->players[player_id].money,
-                                                                shm->board, &unique_seed);
-            
-            // Apply the landing result to shared memory
-            shm->players[player_id].money += landing.money_change;
-            
-            // If property was bought, update owner
-            if (landing.property_bought) {
-                shm->board[pos].owner = player_id;
-                logger_log("Player %d bought %s", player_id, shm->board[pos].name);
+        if ((action == 'r' || action == 'b') && !shm->players[player_id].is_bankrupt) {
+            // 'b' builds one level on a completed group before rolling
+            char built[64] = "";
+            if (action == 'b') {
+                int tile = build_next_house(shm, board, player_id);
+                if (tile >= 0) {
+                    replay_record(shm, (ReplayRecord){ .kind = REPLAY_BUILD, .player = player_id, .a = tile });
+                    snprintf(built, sizeof(built), "Built on %s. ", board->tiles[tile].name);
+                } else {
+                    snprintf(built, sizeof(built), "Nothing to build. ");
+                }
             }
             
-            // If rent was paid, transfer to owner
-            if (landing.owner_id != -1 && landing.owner_id != player_id) {
-                shm->players[landing.owner_id].money += (-landing.money_change);
-                logger_log("Player %d paid $%d rent to Player %d", 
-                          player_id, -landing.money_change, landing.owner_id);
-            }
-            
-            // Log the landing
-            if (landing.money_change != 0) {
-                logger_log("Player %d: %s (money change: %d)", player_id, landing.message, landing.money_change);
-            } else {
-                logger_log("Player %d: %s", player_id, landing.message);
-            }
+            // Server rolls from the room's recorded dice seed and resolves the landing
+            int dice;
+            LandingResult landing = roll_turn(shm, &dispatch, player_id, &dice);
+            logger_log("Player %d rolled %d", player_id, dice);
+            commit_landing(shm, board, player_id, &landing);
+            record_roll(shm, player_id, dice, &landing);
+            char landed[192];
+            log_landing(board, player_id, &landing, landed, sizeof(landed));
             
-            // Check bankruptcy
-            if (landing.is_bankrupt) {
-                shm->players[player_id].is_bankrupt = 1;
-                shm->active_player_count--;
-                logger_log("Player %d went bankrupt", player_id);
+            // A tile the player could not afford goes to the table
+            char auctioned[128] = "";
+            if (landing.for_auction && !shm->players[player_id].is_bankrupt &&
+                run_auction(shm, board, player_id, landing.new_position, client_socket,
+                            auctioned, sizeof(auctioned)) < 0) {
+                logger_log("Player %d lost the lock of room %u", player_id, room.index);
+                break;
             }
             
             // Format message for client with bounded append to avoid truncation warnings
-            int prefix_len = snprintf(pkt.message, sizeof(pkt.message), "Rolled %d. ", dice);
+            int prefix_len = snprintf(pkt.message, sizeof(pkt.message), "%sRolled %d. ", built, dice);
             if (prefix_len < 0) {
                 prefix_len = 0;
                 pkt.message[0] = '\0';
             }
             size_t remaining = sizeof(pkt.message) - (size_t)prefix_len - 1;
-            snprintf(pkt.message + prefix_len, remaining + 1, "%.*s", (int)remaining, landing.message);
+            snprintf(pkt.message + prefix_len, remaining + 1, "%.*s%s", (int)remaining, landed, auctioned);
             
             // Send update
             pkt.type = MSG_UPDATE;
             pkt.position = shm->players[player_id].position;
             pkt.money = shm->players[player_id].money;
+        } else if (action == TRADE_TAG) {
+            // Leave the offer with the other player; the turn carries on
+            offer.from = player_id;
+            TradeStatus status = trade_propose(shm, board, &offer);
+            if (status == TRADE_OK) {
+                ReplayRecord rec = { .kind = REPLAY_TRADE_OFFER, .player = player_id,
+                                     .ref = offer.id, .a = offer.to, .b = offer.cash };
+                memcpy(rec.give, offer.give, sizeof(rec.give));
+                memcpy(rec.take, offer.take, sizeof(rec.take));
+                replay_record(shm, rec);
+                wake_seat(shm, offer.to);
+                logger_log("Player %d offered trade #%u to Player %d", player_id, offer.id, offer.to);
+                snprintf(pkt.message, sizeof(pkt.message), "Trade #%u sent to Player %d",
+                         offer.id, offer.to);
+            } else {
+                snprintf(pkt.message, sizeof(pkt.message), "Trade not sent (%s)",
+                         trade_status_name(status));
+            }
+            pkt.type = MSG_UPDATE;
         } else {
             // Invalid action - send current state
             pkt.type = MSG_UPDATE;
             snprintf(pkt.message, sizeof(pkt.message), "Invalid action");
+            replay_record(shm, (ReplayRecord){ .kind = REPLAY_SKIP, .player = player_id });
         }
         
         if (write(client_socket, &pkt, sizeof(Packet)) < 0) {
@@ -216,52 +574,502 @@ void handle_client(int client_socket, int player_id) {
             break;
         }
         
+        // Proposing a trade does not use up the turn
+        if (action == TRADE_TAG) {
+            pthread_mutex_unlock(&shm->game_mutex);
+            continue;
+        }
+        
         // Advance turn
         advance_turn(shm);
-        pthread_cond_broadcast(&shm->turn_cond);
         pthread_mutex_unlock(&shm->game_mutex);
     }
     
     logger_log("Player %d session ended", player_id);
     close(client_socket);
+    room_unref(shm);
     exit(0);
 }
 
-int main() {
+// Run an automated seat in a child process (no socket)
+void handle_bot(RoomHandle room, int player_id) {
+    logger_log("Bot %d session started in room %u (PID: %d)", player_id, room.index, getpid());
+    
+    GameState *shm = room_get(room);
+    if (!shm) {
+        logger_log("Bot %d: room %u is gone", player_id, room.index);
+        exit(1);
+    }
+    
+    TileDispatch dispatch;
+    const BoardDef *board = NULL;
+    
+    // Search threads must be created after fork, in the child
+    MctsEngine *engine = mcts_create(NULL, &bot_policy);
+    if (!engine) {
+        logger_log("Bot %d failed to create search engine", player_id);
+        room_unref(shm);
+        exit(1);
+    }
+    
+    while (1) {
+        int held = lock_game_state(shm, player_id) >= 0;
+        while (held && (shm->game_state != PLAYING || shm->current_turn != player_id) && 
+               shm->game_state != GAME_OVER) {
+            if (auction_wants_bid(&shm->auction, player_id) &&
+                (board || (board = load_room_board(shm, &dispatch)))) {
+                held = place_bid(shm, board, player_id, -1) == 0;
+                continue;
+            }
+            if (trade_waiting(shm, player_id) &&
+                (board || (board = load_room_board(shm, &dispatch)))) {
+                held = answer_trade(shm, board, player_id, -1) == 0;
+                continue;
+            }
+            held = wait_seat(shm, player_id, NULL) == 0;
+        }
+        if (!held) {
+            logger_log("Bot %d lost the lock of room %u", player_id, room.index);
+            break;
+        }
+        
+        if (shm->game_state == GAME_OVER) {
+            release_room_board(shm);
+            pthread_mutex_unlock(&shm->game_mutex);
+            break;
+        }
+        
+        if (shm->players[player_id].is_bankrupt) {
+            replay_record(shm, (ReplayRecord){ .kind = REPLAY_SKIP, .player = player_id });
+            advance_turn(shm);
+            pthread_mutex_unlock(&shm->game_mutex);
+            continue;
+        }
+        
+        if (!board && !(board = load_room_board(shm, &dispatch))) {
+            logger_log("Bot %d cannot map board version %u", player_id, shm->board_version);
+            leave_game(shm, player_id);
+            replay_record(shm, (ReplayRecord){ .kind = REPLAY_LEAVE, .player = player_id,
+                                               .flags = REPLAY_FLAG_ADVANCED });
+            advance_turn(shm);
+            pthread_mutex_unlock(&shm->game_mutex);
+            break;
+        }
+
+        // Build while a level still leaves the policy's cash reserve in hand
+        int tile;
+        while ((tile = pick_build_tile(shm, board, player_id)) >= 0 &&
+               shm->players[player_id].money - board->tiles[tile].house_price >= bot_policy.cash_reserve &&
+               (tile = build_next_house(shm, board, player_id)) >= 0) {
+            replay_record(shm, (ReplayRecord){ .kind = REPLAY_BUILD, .player = player_id, .a = tile });
+        }
+
+        int dice;
+        LandingResult landing = roll_turn(shm, &dispatch, player_id, &dice);
+        logger_log("Bot %d rolled %d", player_id, dice);
+        int pos = landing.new_position;
+        
+        // Purchase offers go to the search; the snapshot keeps it off game_mutex
+        if (landing.property_bought) {
+            SimGame root;
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            unsigned int search_seed = ts.tv_nsec + player_id * 12345;
+            if (sim_init(&root, shm, board, search_seed) == 0) {
+                pthread_mutex_unlock(&shm->game_mutex);
+                
+                SimMove pending = { player_id, dice, pos, landing };
+                MctsStats stats;
+                int buy = mcts_decide_purchase(engine, &root, &pending, &stats);
+                logger_log("Bot %d %s %s (%ld rollouts, %d nodes, %ldus)",
+                           player_id, buy ? "buys" : "passes on", board->tiles[pos].name,
+                           stats.iterations, stats.nodes, stats.elapsed_us);
+                
+                if (lock_game_state(shm, player_id) < 0) {
+                    logger_log("Bot %d lost the lock of room %u", player_id, room.index);
+                    break;
+                }
+                if (!buy) {
+                    decline_purchase(&landing);
+                }
+            } else if (!bot_policy_wants(&bot_policy, &board->tiles[pos], pos,
+                                         shm->players[player_id].money)) {
+                decline_purchase(&landing);     // Past the packed limits: no search, the policy decides
+            }
+        }
+        
+        commit_landing(shm, board, player_id, &landing);
+        record_roll(shm, player_id, dice, &landing);
+        char landed[192];
+        log_landing(board, player_id, &landing, landed, sizeof(landed));
+        char auctioned[128];
+        if (landing.for_auction && !shm->players[player_id].is_bankrupt &&
+            run_auction(shm, board, player_id, pos, -1, auctioned, sizeof(auctioned)) < 0) {
+            logger_log("Bot %d lost the lock of room %u", player_id, room.index);
+            break;
+        }
+        advance_turn(shm);
+        pthread_mutex_unlock(&shm->game_mutex);
+    }
+    
+    mcts_destroy(engine);
+    logger_log("Bot %d session ended", player_id);
+    room_unref(shm);
+    exit(0);
+}
+
+// Children must not outlive the server: a restarted server re-forks the
+// seats of a file-backed room, and stale children would still write to it
+static void die_with_server(void) {
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != server_pid) {
+        exit(1);
+    }
+}
+
+// Fork the process that plays a bot seat (its room reference is taken)
+static void spawn_bot(GameState *room, int player_id) {
+    RoomHandle handle = room_handle(room);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(server_fd);
+        die_with_server();
+        handle_bot(handle, player_id);
+    } else if (pid > 0) {
+        scheduler_player_connect(player_id);
+    } else {
+        perror("fork");
+        room_unref(room);
+    }
+}
+
+// Claim the next free seat of the seating room, taking a room reference
+// for the seat's process, and start the game once enough players (and
+// all of the table's bots) joined. Returns the player ID, SEAT_NEXT_ROOM
+// if the room is over or full, or -1 if it cannot be locked.
+static int take_seat(const char *origin, int is_bot) {
+    if (lock_game_state(game_state, -1) < 0) {
+        logger_log("Connection rejected - room %u cannot be locked", room_handle(game_state).index);
+        return -1;
+    }
+    
+    // Joining is allowed during setup and play; a finished or full room makes way for a new one
+    if (game_state->game_state == GAME_OVER || game_state->num_players >= table_seats) {
+        pthread_mutex_unlock(&game_state->game_mutex);
+        return SEAT_NEXT_ROOM;
+    }
+    
+    // Assign player ID
+    state_write_begin(game_state);
+    int player_id = game_state->num_players++;
+    game_state->players[player_id].money = game_state->start_money;
+    game_state->players[player_id].position = 0;
+    seat_join(game_state, player_id);
+    state_write_end(game_state);
+    room_ref(game_state);
+    if (is_bot) {
+        game_state->bot_mask |= seat_bit(player_id);
+    }
+    if (game_state->game_state == PLAYING) {
+        replay_record(game_state, (ReplayRecord){ .kind = REPLAY_JOIN, .player = player_id });
+    }
+    
+    logger_log("Player %d connected from %s (Total: %d/%d, %d to start)", 
+               player_id, origin, 
+               game_state->num_players, table_seats, MIN_PLAYERS);
+    
+    // Start game if we have enough players
+    if (game_state->num_players >= MIN_PLAYERS && game_state->num_players >= num_bots &&
+        game_state->game_state == WAITING) {
+        // The room keeps the latest board version for the whole game
+        uint32_t version = board_registry_pin(board_registry);
+        const BoardDef *board = board_registry_map(board_registry, version);
+        if (board) {
+            state_write_begin(game_state);
+            init_board(game_state, board);
+            game_state->board_version = version;
+            for (int i = 0; i < game_state->num_players; i++) {
+                game_state->players[i].money = game_state->start_money;
+            }
+            game_state->game_state = PLAYING;
+            game_state->current_turn = 0;
+            game_state->round = 0;
+            
+            // Seed and record the game so it can be replayed turn by turn
+            replay_seed_game(game_state, (unsigned int)time(NULL) ^ (unsigned int)getpid() ^ (unsigned int)rand());
+            state_write_end(game_state);
+            replay_start(game_state, board, board_file);
+            logger_log("Game starting with %d players on %s (board version %u)",
+                       game_state->num_players, game_state->board_name, version);
+            printf("[SERVER] Game starting with %d players!\n", game_state->num_players);
+            wake_seat(game_state, game_state->current_turn);
+            board_registry_release(board);
+        } else {
+            board_registry_unpin(board_registry, version);
+            logger_log("Cannot start game: board version %u unavailable", version);
+        }
+    }
+    
+    pthread_mutex_unlock(&game_state->game_mutex);
+    return player_id;
+}
+
+// Seat the -b bots at the seating room (before humans, so short-handed
+// tables can still start)
+static void seat_bots(void) {
+    for (int i = 0; i < num_bots; i++) {
+        int player_id = take_seat("bot", 1);
+        if (player_id < 0) {
+            break;
+        }
+        spawn_bot(game_state, player_id);
+    }
+}
+
+// Move seating on to a fresh room once the current one takes no more
+// players. The old room lives on until its last player has left.
+static int open_next_room(void) {
+    RoomHandle handle = room_alloc();
+    GameState *room = room_get(handle);
+    if (!room) {
+        logger_log("Connection rejected - all %d rooms are in use", ROOM_SLOTS);
+        return -1;
+    }
+    
+    GameState *finished = game_state;
+    game_state = room;
+    room_unref(finished);
+    const BoardDef *board = board_registry_map(board_registry, board_registry_current(board_registry));
+    init_board(room, board);
+    board_registry_release(board);
+    logger_log("Opened room %u (%d in use)", handle.index, rooms_open());
+    seat_bots();
+    return 0;
+}
+
+// After a warm restart, newcomers take over the seats that were cut off.
+// The server holds a reference on every room with such seats until the
+// last one is taken or its game ends. Returns the room with the seat in
+// *player_id (reference taken), or NULL if no room has one.
+static GameState *claim_vacant_seat(const char *origin, int *player_id) {
+    for (int i = 0; i < ROOM_SLOTS; i++) {
+        GameState *room = room_at(i);
+        if (!room || room == game_state || !__atomic_load_n(&room->vacant_mask, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        if (lock_game_state(room, -1) < 0) {
+            // Lost for good: stop offering its seats and drop the server's reference
+            if (__atomic_exchange_n(&room->vacant_mask, 0, __ATOMIC_ACQ_REL)) {
+                room_unref(room);
+            }
+            continue;
+        }
+        int seat = -1;
+        if (room->vacant_mask && room->game_state == PLAYING) {
+            seat = __builtin_ctzll(room->vacant_mask);
+            room->vacant_mask &= ~seat_bit(seat);
+            room_ref(room);
+        } else {
+            room->vacant_mask = 0;
+        }
+        int waiting = room->vacant_mask != 0;
+        pthread_mutex_unlock(&room->game_mutex);
+        if (!waiting) {
+            room_unref(room);
+        }
+        if (seat >= 0) {
+            logger_log("Player %d reconnected to room %d from %s", seat, i, origin);
+            *player_id = seat;
+            return room;
+        }
+    }
+    return NULL;
+}
+
+// Seat a connecting player, in a cut-off seat or else at the seating room.
+// Returns the room (reference taken for the seat), or NULL if rejected.
+static GameState *seat_player(const char *origin, int *player_id) {
+    GameState *room = claim_vacant_seat(origin, player_id);
+    if (room) {
+        return room;
+    }
+    *player_id = take_seat(origin, 0);
+    if (*player_id == SEAT_NEXT_ROOM && open_next_room() == 0) {
+        *player_id = take_seat(origin, 0);
+    }
+    if (*player_id == SEAT_NEXT_ROOM) {
+        logger_log("Connection rejected - room %u is full", room_handle(game_state).index);
+    }
+    return *player_id >= 0 ? game_state : NULL;
+}
+
+// Pick a game found in the room file back up on the board version just
+// published (board versions do not survive a restart). Human seats wait
+// for reconnections; returns 0, or -1 if the board no longer fits.
+static int resume_room(GameState *room, uint32_t version) {
+    const BoardDef *board = board_registry_map(board_registry, version);
+    int fits = board && (int)board->tile_count == room->board_size;
+    board_registry_release(board);
+    if (!fits) {
+        return -1;
+    }
+    uint32_t pinned = board_registry_pin(board_registry);
+    state_write_begin(room);
+    room->board_version = pinned;
+    state_write_end(room);
+    
+    room->vacant_mask = room->alive_mask & ~room->bot_mask;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
     struct sockaddr_in server_addr, client_addr;
     socklen_t addr_len = sizeof(client_addr);
     int opt = 1;
+    const char *instance = NULL;
+    SegmentPaging paging = { SEGMENT_PAGES_NORMAL, 0, NULL };
+    
+    bot_policy_default(&bot_policy);
+    
+    int c;
+    while ((c = getopt(argc, argv, "b:n:p:B:S:i:H:P")) != -1) {
+        switch (c) {
+            case 'b':
+                num_bots = atoi(optarg);
+                break;
+            case 'n':
+                table_seats = atoi(optarg);
+                break;
+            case 'p':
+                if (bot_policy_load(&bot_policy, optarg) != 0) {
+                    fprintf(stderr, "Failed to load bot policy %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'B':
+                board_file = optarg;
+                break;
+            case 'S':
+                room_file = optarg;
+                break;
+            case 'i':
+                instance = optarg;
+                break;
+            case 'H':
+                // Huge pages for the room slab and scheduler: "thp", or a hugetlbfs mount
+                if (strcmp(optarg, "thp") == 0) {
+                    paging.pages = SEGMENT_PAGES_THP;
+                } else {
+                    paging.pages = SEGMENT_PAGES_HUGETLB;
+                    paging.hugetlb_dir = optarg;
+                }
+                break;
+            case 'P':
+                paging.prefault = 1;
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-b bots] [-n seats] [-p bot_policy.txt] [-B board] [-S room_file] "
+                        "[-i instance] [-H thp|hugetlbfs_dir] [-P]\n", argv[0]);
+                return 1;
+        }
+    }
+    
+    // Every IPC name, the log and scores files and the port belong to the instance
+    if (instance_init(instance) != 0) {
+        return 1;
+    }
+    int port = instance_port();
+    if (table_seats < MIN_PLAYERS || table_seats > MAX_PLAYERS) {
+        fprintf(stderr, "Seats per table must be %d-%d\n", MIN_PLAYERS, MAX_PLAYERS);
+        return 1;
+    }
+    if (num_bots < 0 || num_bots > table_seats) {
+        fprintf(stderr, "Bot count must be 0-%d\n", table_seats);
+        return 1;
+    }
     
     srand(time(NULL));
     
     // Setup signal handlers
+    server_pid = getpid();
     signal(SIGINT, sig_handler);
     signal(SIGCHLD, sig_handler);
     
+    // SIGHUP must interrupt accept() in the main thread: block it now so the
+    // helper threads inherit the mask, and unblock it before accepting
+    sigset_t hup_set;
+    sigemptyset(&hup_set);
+    sigaddset(&hup_set, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &hup_set, NULL);
+    struct sigaction hup_action;
+    memset(&hup_action, 0, sizeof(hup_action));
+    hup_action.sa_handler = sig_handler;
+    sigemptyset(&hup_action.sa_mask);
+    sigaction(SIGHUP, &hup_action, NULL);
+    
     // Initialize logger (creates thread automatically)
-    if (logger_init("game.log") != 0) {
+    char log_file[64];
+    instance_file_name(log_file, sizeof(log_file), "game.log");
+    if (logger_init(log_file) != 0) {
         fprintf(stderr, "Failed to initialize logger\n");
         return 1;
     }
     
     logger_log("=== Monopoly Server Starting ===");
     
-    // Initialize shared memory
-        game_state = init_game_state_memory();
-    if (!game_state) {
+    // Initialize shared memory (the room slab and board registry in one
+    // segment), or remap the room file a previous run left behind. Each
+    // segment reports the mapping it got.
+    segment_set_paging(&paging);
+    int kept = 0;
+    if ((room_file ? open_room_slab_file(room_file, &kept) : init_room_slab()) != 0) {
         logger_log("Failed to initialize shared memory");
         logger_shutdown();
         return 1;
     }
     
-    // Load persistent scores
-    load_scores(game_state);
-    logger_log("Loaded scores from file");
+    // Publish the first board version (SIGHUP republishes board_file)
+    board_registry = board_registry_init(game_state_boards());
+    uint32_t board_version = board_registry ? board_registry_publish(board_registry, board_file) : 0;
+    if (!board_version) {
+        fprintf(stderr, "Failed to load board %s\n", board_file);
+        board_registry_destroy(board_registry);
+        cleanup_room_slab();
+        logger_shutdown();
+        return 1;
+    }
+    
+    // Games the room file held go on; anything else starts a new table
+    for (int i = 0; i < ROOM_SLOTS; i++) {
+        GameState *room = room_at(i);
+        if (room && resume_room(room, board_version) != 0) {
+            logger_log("Cannot resume the saved game in room %d on %s; dropping it", i, board_file);
+            room_unref(room);
+        }
+    }
+    game_state = room_get(room_alloc());
+    if (!game_state) {
+        logger_log("No free room slot for new players");
+        board_registry_destroy(board_registry);
+        cleanup_room_slab();
+        logger_shutdown();
+        return 1;
+    }
+    const BoardDef *board = board_registry_map(board_registry, board_version);
+    init_board(game_state, board);
+    board_registry_release(board);
+    
+    // Load persistent scores (a kept room file already has them)
+    if (!kept) {
+        load_scores();
+        logger_log("Loaded scores from file");
+    }
     
     // Initialize scheduler
-    if (scheduler_init(MAX_CLIENTS) != 0) {
+    if (scheduler_init(table_seats) != 0) {
         logger_log("Failed to initialize scheduler");
-            cleanup_game_state_memory(game_state);
+        board_registry_destroy(board_registry);
+        cleanup_room_slab();
         logger_shutdown();
         return 1;
     }
@@ -271,12 +1079,20 @@ int main() {
     if (scheduler_thread_id == 0) {
         logger_log("Failed to start scheduler thread");
         scheduler_cleanup();
-            cleanup_game_state_memory(game_state);
+        board_registry_destroy(board_registry);
+        cleanup_room_slab();
         logger_shutdown();
         return 1;
     }
     logger_log("Scheduler thread started");
     
+    // Win-probability estimation only ever gets idle CPU
+    estimator_pool = pool_create(0, 1);
+    win_estimator = estimator_pool ? estimator_start(board_registry, estimator_pool) : NULL;
+    if (!win_estimator) {
+        logger_log("Win-probability estimator disabled");
+    }
+    
     // Create server socket
     server_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (server_fd < 0) {
@@ -288,7 +1104,7 @@ int main() {
     
     server_addr.sin_family = AF_INET;
     server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(PORT);
+    server_addr.sin_port = htons(port);
     
     if (bind(server_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
         perror("bind");
@@ -302,67 +1118,67 @@ int main() {
         return 1;
     }
     
-    logger_log("Server listening on port %d", PORT);
-    printf("[SERVER] Listening on port %d...\n", PORT);
+    logger_log("Server listening on port %d (instance \"%s\")", port, instance_name());
+    printf("[SERVER] Listening on port %d...\n", port);
+    
+    pthread_sigmask(SIG_UNBLOCK, &hup_set, NULL);
+    
+    // Resumed games get their own bots back; the server's reference stays
+    // only while seats wait for reconnections
+    for (int i = 0; i < ROOM_SLOTS; i++) {
+        GameState *room = room_at(i);
+        if (!room || room == game_state) {
+            continue;
+        }
+        for (SeatMask bots = room->bot_mask & room->alive_mask; bots; bots &= bots - 1) {
+            room_ref(room);
+            spawn_bot(room, __builtin_ctzll(bots));
+        }
+        printf("[SERVER] Resumed game in room %d at turn %ld; waiting for %d player(s) to reconnect\n",
+               i, room->move_count, seat_count(room->vacant_mask));
+        if (!room->vacant_mask) {
+            room_unref(room);
+        }
+    }
+    seat_bots();
     
     // Accept loop
     while (1) {
         int client_socket = accept(server_fd, (struct sockaddr*)&client_addr, &addr_len);
-        if (client_socket < 0) {
-            perror("accept");
-            continue;
-        }
         
-        pthread_mutex_lock(&game_state->game_mutex);
+        // Hot reload: running games keep their version, new games get this one
+        if (reload_requested) {
+            reload_requested = 0;
+            uint32_t version = board_registry_publish(board_registry, board_file);
+            if (version) {
+                printf("[SERVER] Published board version %u from %s\n", version, board_file);
+            } else {
+                logger_log("Board reload from %s failed; keeping version %u",
+                           board_file, board_registry_current(board_registry));
+            }
+        }
         
-        // Check if we can accept more players
-        if (game_state->num_players >= MAX_CLIENTS) {
-            logger_log("Connection rejected - game full");
-            pthread_mutex_unlock(&game_state->game_mutex);
-            close(client_socket);
+        if (client_socket < 0) {
+            if (errno != EINTR) {
+                perror("accept");
+            }
             continue;
         }
         
-        // Only reject if game is completely over (allow joining during initial setup/playing)
-        if (game_state->game_state == GAME_OVER) {
-            logger_log("Connection rejected - game over");
-            pthread_mutex_unlock(&game_state->game_mutex);
+        int player_id;
+        GameState *room = seat_player(inet_ntoa(client_addr.sin_addr), &player_id);
+        if (!room) {
             close(client_socket);
             continue;
         }
         
-        // Assign player ID
-        int player_id = game_state->num_players++;
-        game_state->players[player_id].id = player_id;
-        game_state->players[player_id].money = START_MONEY;
-        game_state->players[player_id].position = 0;
-        game_state->players[player_id].is_active = 1;
-        game_state->players[player_id].is_bankrupt = 0;
-        game_state->active_player_count++;
-        
-        logger_log("Player %d connected from %s (Total: %d/%d)", 
-                   player_id, inet_ntoa(client_addr.sin_addr), 
-                   game_state->num_players, MIN_CLIENTS);
-        
-        // Start game if we have enough players
-        if (game_state->num_players >= MIN_CLIENTS && 
-            game_state->game_state == WAITING) {
-            game_state->game_state = PLAYING;
-            game_state->current_turn = 0;
-            game_state->round = 0;
-            logger_log("Game starting with %d players", game_state->num_players);
-            printf("[SERVER] Game starting with %d players!\n", game_state->num_players);
-            pthread_cond_broadcast(&game_state->turn_cond);
-        }
-        
-        pthread_mutex_unlock(&game_state->game_mutex);
-        
         // Fork child process to handle this client
         pid_t pid = fork();
         if (pid == 0) {
             // Child process
             close(server_fd);
-            handle_client(client_socket, player_id);
+            die_with_server();
+            handle_client(client_socket, room_handle(room), player_id);
         } else if (pid > 0) {
             // Parent process
             close(client_socket);
@@ -370,6 +1186,7 @@ int main() {
         } else {
             perror("fork");
             close(client_socket);
+            room_unref(room);
         }
     }
     
@@ -1,9 +1,12 @@
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
 #include <fcntl.h>
 #include <sys/wait.h>
 #include "shared_memory.h"
@@ -108,4 +111,411 @@ void clean_shared_memory(SharedData *memory, const char *name, size_t size) {
     } else {
         printf("Successfully cleaned up %s memory!\n", name);
     }
-}
\ No newline at end of file
+}
+
+static SegmentPaging paging = { SEGMENT_PAGES_NORMAL, 0, NULL };
+
+static const char *const page_names[] = {
+    [SEGMENT_PAGES_NORMAL] = "normal pages",
+    [SEGMENT_PAGES_THP] = "thp",
+    [SEGMENT_PAGES_HUGETLB] = "hugetlbfs"
+};
+
+void segment_set_paging(const SegmentPaging *p) {
+    paging = *p;
+}
+
+// PMD-sized transparent huge page (2 MiB where the kernel does not say)
+static size_t thp_size(void) {
+    size_t size = 2u << 20;
+    FILE *f = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+    if (f) {
+        unsigned long value;
+        if (fscanf(f, "%lu", &value) == 1 && value > 0) {
+            size = value;
+        }
+        fclose(f);
+    }
+    return size;
+}
+
+static size_t round_up(size_t size, size_t unit) {
+    return (size + unit - 1) / unit * unit;
+}
+
+// Backing file for a segment on the hugetlbfs mount, sized to whole huge
+// pages. Returns the descriptor, or -1 (and why) to fall back to /dev/shm.
+static int hugetlb_create(Segment *seg, const char *name, size_t size, size_t *map_size) {
+    const char *dir = paging.hugetlb_dir;
+    struct statfs st;
+    if (dir == NULL || statfs(dir, &st) == -1 || st.f_type != HUGETLBFS_MAGIC) {
+        fprintf(stderr, "[SHM] Warning: %s is not a hugetlbfs mount; %s falls back to normal pages\n",
+                dir ? dir : "(none)", name);
+        return -1;
+    }
+    snprintf(seg->path, sizeof(seg->path), "%s%s", dir, name);
+    unlink(seg->path);
+    *map_size = round_up(size, (size_t)st.f_bsize);
+    int fd = open(seg->path, O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd == -1 || ftruncate(fd, (off_t)*map_size) == -1) {
+        fprintf(stderr, "[SHM] Warning: cannot create %s: %s; %s falls back to normal pages\n",
+                seg->path, strerror(errno), name);
+        if (fd != -1) {
+            close(fd);
+            unlink(seg->path);
+        }
+        seg->path[0] = '\0';
+        return -1;
+    }
+    return fd;
+}
+
+// Fault every page in now, writable, so the first turns do not
+static void segment_prefault(void *map, size_t size) {
+    madvise(map, size, MADV_WILLNEED);
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(map, size, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+    // Older kernels: touch each page (nothing else runs in the segment yet)
+    long page = sysconf(_SC_PAGESIZE);
+    volatile char *bytes = map;
+    for (size_t i = 0; i < size; i += (size_t)page) {
+        bytes[i] = bytes[i];
+    }
+}
+
+// madvise(MADV_HUGEPAGE) on shmem does nothing unless the administrator
+// allows it; say so rather than report "thp" and get small pages
+static void check_shmem_thp(void) {
+    char line[128] = "";
+    FILE *f = fopen("/sys/kernel/mm/transparent_hugepage/shmem_enabled", "r");
+    if (f) {
+        if (!fgets(line, sizeof(line), f)) {
+            line[0] = '\0';
+        }
+        fclose(f);
+    }
+    if (strstr(line, "[never]") || strstr(line, "[deny]")) {
+        fprintf(stderr, "[SHM] Warning: shmem THP is disabled (transparent_hugepage/shmem_enabled); "
+                "expect no huge pages\n");
+    }
+}
+
+// Map a segment's backing with the paging options. THP has to be advised
+// before the pages exist, so it is populated after mmap rather than with
+// MAP_POPULATE.
+static void *segment_map(Segment *seg, int fd, size_t size, SegmentPages pages) {
+    int flags = MAP_SHARED;
+    if (paging.prefault && pages != SEGMENT_PAGES_THP) {
+        flags |= MAP_POPULATE;
+    }
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (map == MAP_FAILED) {
+        return map;
+    }
+    if (pages == SEGMENT_PAGES_THP) {
+        if (madvise(map, size, MADV_HUGEPAGE) == -1) {
+            fprintf(stderr, "[SHM] Warning: madvise(MADV_HUGEPAGE) failed: %s\n", strerror(errno));
+            pages = SEGMENT_PAGES_NORMAL;
+        } else {
+            check_shmem_thp();
+        }
+    }
+    if (paging.prefault) {
+        segment_prefault(map, size);
+    }
+    seg->pages = pages;
+    seg->prefaulted = paging.prefault;
+    return map;
+}
+
+// Huge page kB the kernel reports for the mapping (smaps), -1 if unknown
+static long segment_huge_kb(const Segment *seg) {
+    FILE *f = fopen("/proc/self/smaps", "r");
+    if (!f) {
+        return -1;
+    }
+    char line[256];
+    int in_mapping = 0;
+    long total = 0;
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long start, end;
+        long kb;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            in_mapping = start == (unsigned long)seg->header;
+        } else if (in_mapping && (sscanf(line, "ShmemPmdMapped: %ld kB", &kb) == 1 ||
+                                  sscanf(line, "FilePmdMapped: %ld kB", &kb) == 1 ||
+                                  sscanf(line, "Shared_Hugetlb: %ld kB", &kb) == 1 ||
+                                  sscanf(line, "Private_Hugetlb: %ld kB", &kb) == 1)) {
+            total += kb;
+        }
+    }
+    fclose(f);
+    return total;
+}
+
+void segment_describe(const Segment *seg, char *out, size_t size) {
+    int len = snprintf(out, size, "%s, %zu kB mapped", page_names[seg->pages], (seg->size + 1023) / 1024);
+    if (seg->pages != SEGMENT_PAGES_NORMAL && len >= 0 && (size_t)len < size) {
+        len += snprintf(out + len, size - (size_t)len, ", %ld kB huge", segment_huge_kb(seg));
+    }
+    if (seg->prefaulted && len >= 0 && (size_t)len < size) {
+        snprintf(out + len, size - (size_t)len, ", prefaulted");
+    }
+}
+
+// Place the parts after the header and hash the result. Returns the total size.
+static size_t segment_layout(const SegmentPart *parts, int count, uint64_t offsets[], uint64_t *hash) {
+    size_t offset = sizeof(SegmentHeader);
+    uint64_t h = 14695981039346656037ULL;
+    uint64_t words[5];
+    
+    for (int i = 0; i < count; i++) {
+        size_t align = parts[i].align > SEGMENT_ALIGN ? parts[i].align : SEGMENT_ALIGN;
+        offset = (offset + align - 1) & ~(align - 1);
+        offsets[i] = offset;
+        
+        words[0] = SEGMENT_VERSION;
+        words[1] = parts[i].size;
+        words[2] = parts[i].align;
+        words[3] = parts[i].layout;
+        words[4] = offset;
+        const unsigned char *bytes = (const unsigned char *)words;
+        for (size_t b = 0; b < sizeof(words); b++) {
+            h = (h ^ bytes[b]) * 1099511628211ULL;
+        }
+        offset += parts[i].size;
+    }
+    
+    *hash = h;
+    return offset;
+}
+
+// Fill in the header of a freshly zeroed mapping; magic goes in last
+static void segment_init_header(void *map, size_t size, uint64_t hash, const uint64_t offsets[], int count) {
+    SegmentHeader *header = (SegmentHeader *)map;
+    header->version = SEGMENT_VERSION;
+    header->layout_hash = hash;
+    header->size = size;
+    header->part_count = (uint32_t)count;
+    memcpy(header->offsets, offsets, (size_t)count * sizeof(uint64_t));
+    __atomic_store_n(&header->magic, SEGMENT_MAGIC, __ATOMIC_RELEASE);
+}
+
+// 0 if the mapping was laid out for these parts; -1 (and why) otherwise
+static int segment_check_header(const SegmentHeader *header, const char *name, uint64_t hash, int count) {
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != SEGMENT_MAGIC ||
+        header->version != SEGMENT_VERSION || header->layout_hash != hash ||
+        header->part_count != (uint32_t)count) {
+        fprintf(stderr, "[SHM] Error: %s was laid out by a different build "
+                "(version %u, layout %016llx; expected %d, %016llx)\n",
+                name, header->version, (unsigned long long)header->layout_hash,
+                SEGMENT_VERSION, (unsigned long long)hash);
+        return ERROR_RESULT;
+    }
+    return 0;
+}
+
+int segment_create(Segment *seg, const char *name, const SegmentPart *parts, int count) {
+    uint64_t offsets[SEGMENT_MAX_PARTS];
+    uint64_t hash;
+    if (count < 1 || count > SEGMENT_MAX_PARTS) {
+        fprintf(stderr, "[SHM] Error: %s: %d parts (1-%d allowed)\n", name, count, SEGMENT_MAX_PARTS);
+        return ERROR_RESULT;
+    }
+    size_t size = segment_layout(parts, count, offsets, &hash);
+    seg->path[0] = '\0';
+    
+    // A hugetlbfs file when asked for (falling back to /dev/shm if the mount
+    // or its page pool cannot take it)
+    SegmentPages pages = paging.pages;
+    size_t map_size = size;
+    void *map = MAP_FAILED;
+    if (pages == SEGMENT_PAGES_HUGETLB) {
+        int fd = hugetlb_create(seg, name, size, &map_size);
+        if (fd != -1) {
+            map = segment_map(seg, fd, map_size, pages);
+            close(fd);
+            if (map == MAP_FAILED) {
+                fprintf(stderr, "[SHM] Warning: cannot map %s: %s; %s falls back to normal pages\n",
+                        seg->path, strerror(errno), name);
+                unlink(seg->path);
+                seg->path[0] = '\0';
+            }
+        }
+        if (map == MAP_FAILED) {
+            pages = SEGMENT_PAGES_NORMAL;
+            map_size = size;
+        }
+    }
+    
+    if (map == MAP_FAILED) {
+        // Whole huge pages, so the tail of the segment is not left on small ones
+        if (pages == SEGMENT_PAGES_THP) {
+            map_size = round_up(size, thp_size());
+        }
+        
+        // A previous run's segment may have another size or layout: start over
+        shm_unlink(name);
+        int shm_fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+        if (shm_fd == -1) {
+            fprintf(stderr, "[SHM] Error: cannot create %s: %s\n", name, strerror(errno));
+            return ERROR_RESULT;
+        }
+        if (ftruncate(shm_fd, (off_t)map_size) == -1) {
+            fprintf(stderr, "[SHM] Error: cannot size %s to %zu bytes: %s\n", name, map_size, strerror(errno));
+            close(shm_fd);
+            shm_unlink(name);
+            return ERROR_RESULT;
+        }
+        map = segment_map(seg, shm_fd, map_size, pages);
+        close(shm_fd);
+        if (map == MAP_FAILED) {
+            fprintf(stderr, "[SHM] Error: cannot map %s: %s\n", name, strerror(errno));
+            shm_unlink(name);
+            return ERROR_RESULT;
+        }
+    }
+    
+    // Fresh pages are already zero; only the header needs filling in
+    segment_init_header(map, size, hash, offsets, count);
+    
+    seg->header = (SegmentHeader *)map;
+    seg->size = map_size;
+    char mode[96];
+    segment_describe(seg, mode, sizeof(mode));
+    printf("Successfully created %s with %zu bytes (%d parts; %s)!\n", name, size, count, mode);
+    return 0;
+}
+
+int segment_attach(Segment *seg, const char *name, const SegmentPart *parts, int count) {
+    uint64_t offsets[SEGMENT_MAX_PARTS];
+    uint64_t hash;
+    if (count < 1 || count > SEGMENT_MAX_PARTS) {
+        return ERROR_RESULT;
+    }
+    size_t size = segment_layout(parts, count, offsets, &hash);
+    
+    int shm_fd = shm_open(name, O_RDWR, 0666);
+    if (shm_fd == -1) {
+        fprintf(stderr, "[SHM] Error: cannot open %s: %s\n", name, strerror(errno));
+        return ERROR_RESULT;
+    }
+    struct stat st;
+    if (fstat(shm_fd, &st) == -1 || (size_t)st.st_size < size) {
+        fprintf(stderr, "[SHM] Error: %s is %lld bytes, this build expects %zu\n",
+                name, (long long)st.st_size, size);
+        close(shm_fd);
+        return ERROR_RESULT;
+    }
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    close(shm_fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[SHM] Error: cannot map %s: %s\n", name, strerror(errno));
+        return ERROR_RESULT;
+    }
+    
+    SegmentHeader *header = (SegmentHeader *)map;
+    if (segment_check_header(header, name, hash, count) != 0) {
+        munmap(map, size);
+        return ERROR_RESULT;
+    }
+    
+    seg->header = header;
+    seg->size = size;
+    seg->pages = SEGMENT_PAGES_NORMAL;
+    seg->prefaulted = 0;
+    seg->path[0] = '\0';
+    return 0;
+}
+
+int segment_open_file(Segment *seg, const char *path, const SegmentPart *parts, int count) {
+    uint64_t offsets[SEGMENT_MAX_PARTS];
+    uint64_t hash;
+    if (count < 1 || count > SEGMENT_MAX_PARTS) {
+        fprintf(stderr, "[SHM] Error: %s: %d parts (1-%d allowed)\n", path, count, SEGMENT_MAX_PARTS);
+        return ERROR_RESULT;
+    }
+    size_t size = segment_layout(parts, count, offsets, &hash);
+    
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd == -1) {
+        fprintf(stderr, "[SHM] Error: cannot open %s: %s\n", path, strerror(errno));
+        return ERROR_RESULT;
+    }
+    struct stat st;
+    int existing = fstat(fd, &st) == 0 && (size_t)st.st_size == size;
+    
+    // Anything else (new, truncated, other build) is started over from zeroes
+    if (!existing && (ftruncate(fd, 0) == -1 || ftruncate(fd, (off_t)size) == -1)) {
+        fprintf(stderr, "[SHM] Error: cannot size %s to %zu bytes: %s\n", path, size, strerror(errno));
+        close(fd);
+        return ERROR_RESULT;
+    }
+    // A regular file's page cache is never huge; only the prefault applies
+    if (paging.pages != SEGMENT_PAGES_NORMAL) {
+        fprintf(stderr, "[SHM] Warning: %s is a regular file; it uses normal pages\n", path);
+    }
+    seg->path[0] = '\0';
+    void *map = segment_map(seg, fd, size, SEGMENT_PAGES_NORMAL);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[SHM] Error: cannot map %s: %s\n", path, strerror(errno));
+        return ERROR_RESULT;
+    }
+    
+    if (existing && segment_check_header((SegmentHeader *)map, path, hash, count) != 0) {
+        fprintf(stderr, "[SHM] Warning: starting %s over\n", path);
+        memset(map, 0, size);
+        existing = 0;
+    }
+    if (!existing) {
+        segment_init_header(map, size, hash, offsets, count);
+    }
+    
+    seg->header = (SegmentHeader *)map;
+    seg->size = size;
+    char mode[96];
+    segment_describe(seg, mode, sizeof(mode));
+    printf("Successfully %s %s with %zu bytes (%d parts; %s)!\n",
+           existing ? "remapped" : "created", path, size, count, mode);
+    return existing;
+}
+
+void segment_sync(const Segment *seg) {
+    if (seg->header != NULL && msync(seg->header, seg->size, MS_SYNC) == -1) {
+        fprintf(stderr, "[SHM] Error: msync failed: %s\n", strerror(errno));
+    }
+}
+
+void *segment_part(const Segment *seg, int index) {
+    if (seg->header == NULL || index < 0 || (uint32_t)index >= seg->header->part_count) {
+        return NULL;
+    }
+    return (char *)seg->header + seg->header->offsets[index];
+}
+
+void segment_detach(Segment *seg) {
+    if (seg->header != NULL) {
+        munmap(seg->header, seg->size);
+        seg->header = NULL;
+        seg->size = 0;
+    }
+}
+
+void segment_destroy(Segment *seg, const char *name) {
+    segment_detach(seg);
+    if (seg->path[0] != '\0') {
+        unlink(seg->path);      // hugetlbfs backing file
+        seg->path[0] = '\0';
+        printf("Successfully cleaned up %s memory!\n", name);
+        return;
+    }
+    if (shm_unlink(name) == -1) {
+        perror("Failed to delete shared memory!!\n");
+    } else {
+        printf("Successfully cleaned up %s memory!\n", name);
+    }
+}
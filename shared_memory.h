@@ -2,6 +2,7 @@
 #define SHARED_MEMORY_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #define NUM_PROCESSES 4
 #define MAX_MSG_SIZE 256
@@ -20,4 +21,89 @@ SharedData* attach_shared_memory(const char *name, size_t size);
 void detach_shared_memory(SharedData *memory, size_t size);
 void clean_shared_memory(SharedData *memory, const char *name, size_t size);
 
+// Typed segments
+// A segment is one shared memory object holding a SegmentHeader followed by
+// one or more parts, each sized and aligned from its C type. Processes
+// attach once and get every part. The header records the layout (part
+// sizes, alignments, offsets and each type's layout tag); a binary built
+// with a different layout refuses to attach instead of misreading memory.
+
+#define SEGMENT_MAGIC 0x4d53474du   // "MGSM"
+#define SEGMENT_VERSION 1
+#define SEGMENT_MAX_PARTS 8
+#define SEGMENT_ALIGN 64            // Every part starts on its own cache line
+
+typedef struct {
+    const char *type;       // For error messages
+    size_t size;
+    size_t align;
+    uint32_t layout;        // Type's layout tag (e.g. from offsetof of its fields)
+} SegmentPart;
+
+#define SEGMENT_PART(type, layout) { #type, sizeof(type), _Alignof(type), (layout) }
+
+typedef struct {
+    uint32_t magic;                     // Written last by the creator
+    uint32_t version;
+    uint64_t layout_hash;
+    uint64_t size;                      // Whole mapping, header included
+    uint32_t part_count;
+    uint32_t reserved;
+    uint64_t offsets[SEGMENT_MAX_PARTS];
+} SegmentHeader;
+
+// How segments created from now on are backed (segment_set_paging). Huge
+// pages keep a large segment down to a few TLB entries; prefaulting takes
+// every page fault at startup instead of on the first turns.
+typedef enum {
+    SEGMENT_PAGES_NORMAL,       // Ordinary /dev/shm pages
+    SEGMENT_PAGES_THP,          // /dev/shm object with madvise(MADV_HUGEPAGE)
+    SEGMENT_PAGES_HUGETLB       // File on a hugetlbfs mount
+} SegmentPages;
+
+typedef struct {
+    SegmentPages pages;
+    int prefault;               // Populate every page when the segment is mapped
+    const char *hugetlb_dir;    // Mount point for SEGMENT_PAGES_HUGETLB
+} SegmentPaging;
+
+typedef struct {
+    SegmentHeader *header;
+    size_t size;                // Mapped bytes (rounded up to the huge page size)
+    SegmentPages pages;         // What the segment actually got (a failed request falls back)
+    int prefaulted;
+    char path[128];             // Backing file of a hugetlbfs segment
+} Segment;
+
+// Set the backing for segments created or opened after this call
+void segment_set_paging(const SegmentPaging *paging);
+
+// One-line description of a segment's mapping for startup reports, e.g.
+// "thp, 2048 kB huge, prefaulted" (huge kB as the kernel reports it)
+void segment_describe(const Segment *seg, char *out, size_t size);
+
+// Create (or recreate) a segment for the parts; every part is zeroed.
+// Returns 0, or -1 on error.
+int segment_create(Segment *seg, const char *name, const SegmentPart *parts, int count);
+
+// Map an existing segment, checking it was laid out for the same parts.
+// Returns 0, or -1 if it is missing or from a different build.
+int segment_attach(Segment *seg, const char *name, const SegmentPart *parts, int count);
+
+// Map a segment kept in a regular file, so it outlives the process and a
+// reboot. An existing file laid out for the same parts is remapped as it
+// is; a missing or mismatched one is (re)created zeroed. Returns 1 if the
+// contents were kept, 0 if fresh, -1 on error.
+int segment_open_file(Segment *seg, const char *path, const SegmentPart *parts, int count);
+
+// Flush a file-backed segment to disk (no-op cost for /dev/shm ones)
+void segment_sync(const Segment *seg);
+
+// Address of part `index` in this process
+void *segment_part(const Segment *seg, int index);
+
+// Unmap in this process / unmap and remove the segment
+void segment_detach(Segment *seg);
+void segment_destroy(Segment *seg, const char *name);
+
 #endif
\ No newline at end of file
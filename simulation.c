@@ -0,0 +1,285 @@
+#include "simulation.h"
+#include "zobrist.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_CASH_RESERVE 50
+
+void bot_policy_default(BotPolicy *policy) {
+    memset(policy, 0, sizeof(BotPolicy));
+    policy->cash_reserve = DEFAULT_CASH_RESERVE;
+}
+
+int bot_policy_load(BotPolicy *policy, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+
+    bot_policy_default(policy);
+    if (fscanf(f, "cash_reserve %d\n", &policy->cash_reserve) != 1) {
+        fclose(f);
+        return -1;
+    }
+
+    int tile, bias;
+    while (fscanf(f, "tile %d %d\n", &tile, &bias) == 2) {
+        if (tile >= 0 && tile < PACKED_MAX_TILES) {
+            policy->tile_bias[tile] = (int16_t)bias;
+        }
+    }
+
+    fclose(f);
+    return 0;
+}
+
+int bot_policy_save(const BotPolicy *policy, const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        return -1;
+    }
+
+    fprintf(f, "cash_reserve %d\n", policy->cash_reserve);
+    for (int t = 0; t < PACKED_MAX_TILES; t++) {
+        if (policy->tile_bias[t] != 0) {
+            fprintf(f, "tile %d %d\n", t, policy->tile_bias[t]);
+        }
+    }
+
+    fclose(f);
+    return 0;
+}
+
+// Policies are tuned on packed games; tiles past those have no bias
+static int tile_bias(const BotPolicy *policy, int tile_index) {
+    return tile_index < PACKED_MAX_TILES ? policy->tile_bias[tile_index] : 0;
+}
+
+int bot_policy_wants(const BotPolicy *policy, const Property *tile, int tile_index, int money) {
+    return money - tile->price + tile_bias(policy, tile_index) >= policy->cash_reserve;
+}
+
+int bot_policy_bid(const BotPolicy *policy, const Property *tile, int tile_index, int money) {
+    int bid = money + tile_bias(policy, tile_index) - policy->cash_reserve;
+    if (bid > tile->price) {
+        bid = tile->price;
+    }
+    if (bid > money) {
+        bid = money;
+    }
+    return bid > 0 ? bid : 0;
+}
+
+// Value a policy puts on a trade's tile list
+static int policy_value(const BotPolicy *policy, const BoardDef *board, const uint16_t tiles[]) {
+    int value = 0;
+    for (int i = 0; i < TRADE_MAX_TILES && tiles[i] != TILE_NONE; i++) {
+        value += board->tiles[tiles[i]].price + tile_bias(policy, tiles[i]);
+    }
+    return value;
+}
+
+int bot_policy_accepts(const BotPolicy *policy, const BoardDef *board, const TradeOffer *offer,
+                       int money) {
+    int gain = policy_value(policy, board, offer->give) + offer->cash;
+    int loss = policy_value(policy, board, offer->take);
+    return gain > loss && money + offer->cash >= policy->cash_reserve;
+}
+
+int sim_init(SimGame *game, const GameState *state, const BoardDef *board, unsigned int seed) {
+    if (pack_game_state(state, &game->state) != 0) {
+        return -1;
+    }
+    game->board = board;
+    game->hash = zobrist_hash(&game->state);
+    memcpy(game->owners, state->board_owner, sizeof(game->owners));
+    memcpy(game->rents, state->tile_rent, sizeof(game->rents));
+    build_tile_dispatch(&game->dispatch, board);
+    game->seed = seed;
+    return 0;
+}
+
+void sim_copy_board(SimGame *game, const SimGame *from) {
+    game->board = from->board;
+    game->dispatch = from->dispatch;
+}
+
+void sim_reset(SimGame *game, const PackedGameState *state) {
+    game->state = *state;
+    game->hash = zobrist_hash(state);
+    for (int t = 0; t < state->board_size; t++) {
+        game->owners[t] = packed_get_owner(state, t);
+    }
+    build_rent_table(game->board, game->owners, state->buildings, game->rents);
+}
+
+void sim_redeal_cards(SimGame *game) {
+    for (int d = 0; d < DECK_COUNT; d++) {
+        deck_shuffle_remaining(&game->state.decks[d], (unsigned int)rand_r(&game->seed));
+    }
+}
+
+int sim_roll(SimGame *game, SimMove *move) {
+    PackedGameState *s = &game->state;
+    int player = s->current_turn;
+
+    move->player_id = player;
+    move->dice = roll_dice_seeded(&game->seed);
+    int landed = (packed_get_position(s, player) + move->dice) % s->board_size;
+    move->landing = handle_landing_on_position(&game->dispatch, landed, player,
+                                               s->money[player], game->owners, game->rents,
+                                               s->decks);
+    move->new_position = move->landing.new_position;
+    return move->landing.property_bought;
+}
+
+// 1 if seat may add one building level to tile: can_build() on the packed
+// state, where the whole board fits one ownership word
+static int sim_can_build(const SimGame *game, int tile, int seat) {
+    const PackedGameState *s = &game->state;
+    const Property *prop = &game->board->tiles[tile];
+    int level = s->buildings[tile];
+    if (prop->group == 0 || prop->house_price == 0 || level >= BOARD_HOTEL ||
+        prop->rent[level + 1] == 0 || s->money[seat] < prop->house_price) {
+        return 0;
+    }
+
+    const GroupSpan *span = board_group_span(game->board, prop->group);
+    uint64_t group = span->mask << span->first;
+    if (group == 0 || (s->owned[seat] & group) != group) {
+        return 0;
+    }
+    for (; group; group &= group - 1) {
+        if (s->buildings[__builtin_ctzll(group)] < level) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// pick_build_tile() on the packed state
+static int sim_pick_build_tile(const SimGame *game, int seat) {
+    const PackedGameState *s = &game->state;
+    int best = -1;
+    for (uint64_t owned = s->owned[seat]; owned; owned &= owned - 1) {
+        int tile = __builtin_ctzll(owned);
+        if (!sim_can_build(game, tile, seat)) {
+            continue;
+        }
+        if (best < 0 || s->buildings[tile] < s->buildings[best] ||
+            (s->buildings[tile] == s->buildings[best] &&
+             game->board->tiles[tile].house_price < game->board->tiles[best].house_price)) {
+            best = tile;
+        }
+    }
+    return best;
+}
+
+void sim_build(SimGame *game, const BotPolicy *policy) {
+    PackedGameState *s = &game->state;
+    int seat = s->current_turn;
+    int tile;
+    while ((tile = sim_pick_build_tile(game, seat)) >= 0 &&
+           s->money[seat] - game->board->tiles[tile].house_price >= policy->cash_reserve) {
+        int money = s->money[seat] - game->board->tiles[tile].house_price;
+        game->hash = zobrist_money(game->hash, seat, s->money[seat], money);
+        game->hash = zobrist_building(game->hash, tile, s->buildings[tile], s->buildings[tile] + 1);
+        s->money[seat] = money;
+        s->buildings[tile]++;
+        update_group_rents(game->board, tile, game->owners, s->buildings, game->rents);
+    }
+}
+
+// Sealed bids from every seat still in; the highest (lowest seat on a
+// tie) buys the tile, as settle_auction() decides on the server
+static void sim_auction(SimGame *game, int tile, const BotPolicy *const policies[]) {
+    PackedGameState *s = &game->state;
+    const Property *prop = &game->board->tiles[tile];
+    int winner = -1;
+    int price = 0;
+    for (int p = 0; p < s->num_players; p++) {
+        if (!packed_is_alive(s, p)) {
+            continue;
+        }
+        int bid = bot_policy_bid(policies[p], prop, tile, s->money[p]);
+        if (bid > price) {
+            price = bid;
+            winner = p;
+        }
+    }
+    if (winner < 0) {
+        return;
+    }
+
+    game->hash = zobrist_money(game->hash, winner, s->money[winner], s->money[winner] - price);
+    game->hash = zobrist_owner(game->hash, tile, -1, winner);
+    s->money[winner] -= price;
+    packed_set_owner(s, tile, winner);
+    game->owners[tile] = winner;
+    update_group_rents(game->board, tile, game->owners, s->buildings, game->rents);
+}
+
+void sim_commit(SimGame *game, SimMove *move, int buy, const BotPolicy *const policies[]) {
+    if (move->landing.property_bought && !buy) {
+        decline_purchase(&move->landing);
+    }
+
+    uint8_t bankrupt = game->state.bankrupt_mask;
+    game->hash = zobrist_apply_landing(&game->state, game->hash, move->player_id,
+                                       &move->landing);
+    if (game->state.bankrupt_mask != bankrupt) {
+        // Released portfolios: resync every owner the rules can see
+        for (int t = 0; t < game->state.board_size; t++) {
+            game->owners[t] = packed_get_owner(&game->state, t);
+        }
+        build_rent_table(game->board, game->owners, game->state.buildings, game->rents);
+    } else if (move->landing.property_bought) {
+        game->owners[move->new_position] = move->player_id;
+        update_group_rents(game->board, move->new_position, game->owners,
+                           game->state.buildings, game->rents);
+    }
+    if (move->landing.for_auction && packed_is_alive(&game->state, move->player_id)) {
+        sim_auction(game, move->new_position, policies);
+    }
+    int turn = game->state.current_turn;
+    packed_advance_turn(&game->state);
+    game->hash = zobrist_turn(game->hash, turn, game->state.current_turn);
+}
+
+int sim_playout(SimGame *game, const BotPolicy *const policies[], int max_turns) {
+    PackedGameState *s = &game->state;
+    SimMove move;
+
+    for (int turn = 0; turn < max_turns && s->status != GAME_OVER; turn++) {
+        sim_build(game, policies[s->current_turn]);
+        int buy = 0;
+        if (sim_roll(game, &move)) {
+            const Property *tile = &game->board->tiles[move.new_position];
+            buy = bot_policy_wants(policies[move.player_id], tile, move.new_position,
+                                   s->money[move.player_id]);
+        }
+        sim_commit(game, &move, buy, policies);
+    }
+
+    if (s->status != GAME_OVER) {
+        return -1;
+    }
+    for (int p = 0; p < s->num_players; p++) {
+        if (packed_is_alive(s, p)) {
+            return p;
+        }
+    }
+    return -1;
+}
+
+int sim_net_worth(const SimGame *game, int seat) {
+    const PackedGameState *s = &game->state;
+    int worth = s->money[seat];
+    for (uint64_t owned = s->owned[seat]; owned; owned &= owned - 1) {
+        int tile = __builtin_ctzll(owned);
+        const Property *prop = &game->board->tiles[tile];
+        worth += prop->price + s->buildings[tile] * prop->house_price;
+    }
+    return worth;
+}
@@ -0,0 +1,98 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdint.h>
+#include "packed_state.h"
+#include "game_logic.h"
+
+// Fast, socket-free game simulation on packed state.
+// Landings come from handle_landing_on_position(); every seat plays a
+// BotPolicy for purchases, building and auction bids the way the server's
+// bot seats do. Trades are left out (only humans propose them).
+// Used by bots, tuning and analysis tools.
+
+#define SIM_MAX_TURNS 400   // Safety cap for playouts that never finish
+
+// Buy/hold policy for automated players
+typedef struct {
+    int cash_reserve;                     // Cash to keep in hand after a purchase
+    int16_t tile_bias[PACKED_MAX_TILES];  // Extra $ a seat is willing to dip into for a tile
+} BotPolicy;
+
+// One simulated game on a shared board definition. owners[] and rents[]
+// are kept in sync with state so the rules see the simulated ownership,
+// and hash tracks the Zobrist hash of state across commits.
+typedef struct {
+    PackedGameState state;
+    uint64_t hash;
+    const BoardDef *board;
+    int owners[PACKED_MAX_TILES];
+    int rents[PACKED_MAX_TILES];
+    TileDispatch dispatch;
+    unsigned int seed;
+} SimGame;
+
+// A rolled but not yet committed turn
+typedef struct {
+    int player_id;
+    int dice;
+    int new_position;       // Final position (after any card movement)
+    LandingResult landing;
+} SimMove;
+
+// Default policy: buy whenever the purchase leaves $50 in hand
+void bot_policy_default(BotPolicy *policy);
+
+// Read/write a policy as text ("cash_reserve N" then "tile T BIAS" lines).
+// Both return 0 on success, -1 on failure.
+int bot_policy_load(BotPolicy *policy, const char *path);
+int bot_policy_save(const BotPolicy *policy, const char *path);
+
+// 1 if policy would buy tile_index with `money` in hand
+int bot_policy_wants(const BotPolicy *policy, const Property *tile, int tile_index, int money);
+
+// Sealed auction bid for tile_index: what the policy would dip into, never
+// more than the list price or the cash in hand (0 = pass)
+int bot_policy_bid(const BotPolicy *policy, const Property *tile, int tile_index, int money);
+
+// 1 if a bot receiving `offer` should accept it: what it gets (tiles valued
+// at price plus the policy's bias, and cash) beats what it gives up, and
+// it keeps its cash reserve
+int bot_policy_accepts(const BotPolicy *policy, const BoardDef *board, const TradeOffer *offer,
+                       int money);
+
+// Start a simulation from a live game (caller holds game_mutex).
+// Returns 0, or -1 if the game does not fit the packed limits.
+int sim_init(SimGame *game, const GameState *state, const BoardDef *board, unsigned int seed);
+
+// Copy the board and dispatch table of another simulation (no position)
+void sim_copy_board(SimGame *game, const SimGame *from);
+
+// Rewind a simulation to a packed position (the board is kept)
+void sim_reset(SimGame *game, const PackedGameState *state);
+
+// Reshuffle the undrawn part of every card deck from game->seed. Searches
+// call this per playout so bots never plan around the real deck order.
+void sim_redeal_cards(SimGame *game);
+
+// Roll for the seat to move and resolve the landing without committing.
+// Returns 1 if the move offers a purchase the player may decline.
+int sim_roll(SimGame *game, SimMove *move);
+
+// Build for the seat to move while its policy's cash reserve allows,
+// before it rolls (as bot seats do)
+void sim_build(SimGame *game, const BotPolicy *policy);
+
+// Commit a rolled move (buy = 0 declines an offered purchase), auction a
+// passed-on tile with policies[seat] bidding, and pass the turn
+void sim_commit(SimGame *game, SimMove *move, int buy, const BotPolicy *const policies[]);
+
+// Play until GAME_OVER or max_turns using policies[seat] for every
+// purchase, building and bid. Returns the winning seat, or -1 if the turn
+// cap was hit.
+int sim_playout(SimGame *game, const BotPolicy *const policies[], int max_turns);
+
+// Cash plus purchase price of every tile and building the seat owns
+int sim_net_worth(const SimGame *game, int seat);
+
+#endif // SIMULATION_H
@@ -6,8 +6,21 @@
 /*
  All primitives are initialized with PTHREAD_PROCESS_SHARED attribute
  to safely work across process boundaries (fork).
+ Mutexes are also robust: if the owner dies holding one, the next locker
+ gets it back (EOWNERDEAD) instead of every process deadlocking.
  */
 
+// Take over a mutex whose owner died; the lock is held on return
+static int recover_mutex(pthread_mutex_t *mutex) {
+    fprintf(stderr, "[SYNC] Warning: mutex owner died, recovering the lock\n");
+    if (pthread_mutex_consistent(mutex) != 0) {
+        fprintf(stderr, "[SYNC] Error: failed to make mutex consistent\n");
+        pthread_mutex_unlock(mutex);
+        return -1;
+    }
+    return 1;
+}
+
 
 int sync_mutex_init(pthread_mutex_t *mutex) {
     if (mutex == NULL) {
@@ -30,6 +43,13 @@ int sync_mutex_init(pthread_mutex_t *mutex) {
         return -1;
     }
 
+    // Robust: a lock held by a dead process is handed to the next locker
+    if (pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST) != 0) {
+        fprintf(stderr, "[SYNC] Error: failed to set robust attribute\n");
+        pthread_mutexattr_destroy(&attr);
+        return -1;
+    }
+
     // Initialize the mutex
     if (pthread_mutex_init(mutex, &attr) != 0) {
         fprintf(stderr, "[SYNC] Error: failed to init mutex: %s\n", strerror(errno));
@@ -48,6 +68,9 @@ int sync_mutex_lock(pthread_mutex_t *mutex) {
     }
 
     int result = pthread_mutex_lock(mutex);
+    if (result == EOWNERDEAD) {
+        return recover_mutex(mutex);
+    }
     if (result != 0) {
         fprintf(stderr, "[SYNC] Error: failed to lock mutex: %s\n", strerror(result));
         return -1;
@@ -83,6 +106,8 @@ int sync_mutex_trylock(pthread_mutex_t *mutex) {
         return 0;  // Successfully locked
     } else if (result == EBUSY) {
         return 1;  // Already locked by another thread
+    } else if (result == EOWNERDEAD) {
+        return recover_mutex(mutex) == 1 ? 2 : -1;
     } else {
         fprintf(stderr, "[SYNC] Error: trylock failed: %s\n", strerror(result));
         return -1;
@@ -242,6 +267,9 @@ int sync_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
     }
 
     int result = pthread_cond_wait(cond, mutex);
+    if (result == EOWNERDEAD) {
+        return recover_mutex(mutex);
+    }
     if (result != 0) {
         fprintf(stderr, "[SYNC] Error: failed to wait on condition variable: %s\n", strerror(result));
         return -1;
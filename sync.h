@@ -12,7 +12,10 @@
  * between parent threads and forked child processes in the Monopoly game.
  * 
  * All synchronization primitives are initialized with PTHREAD_PROCESS_SHARED
- * to enable safe coordination across process boundaries.
+ * to enable safe coordination across process boundaries. Mutexes are also
+ * PTHREAD_MUTEX_ROBUST, so a process killed while holding one cannot
+ * deadlock the others: the next locker is told, and should check the data
+ * the dead owner may have left half-updated.
  */
 
 /* ============================================================================
@@ -20,7 +23,7 @@
  * ============================================================================ */
 
 /**
- * Initialize a process-shared mutex
+ * Initialize a process-shared, robust mutex
  * 
  * @param mutex Pointer to pthread_mutex_t to initialize
  * @return 0 on success, -1 on failure
@@ -31,7 +34,8 @@ int sync_mutex_init(pthread_mutex_t *mutex);
  * Lock a mutex (blocking)
  * 
  * @param mutex Pointer to pthread_mutex_t to lock
- * @return 0 on success, -1 on failure
+ * @return 0 on success, 1 if locked after its previous owner died (the
+ *         mutex is consistent again), -1 on failure
  */
 int sync_mutex_lock(pthread_mutex_t *mutex);
 
@@ -47,7 +51,8 @@ int sync_mutex_unlock(pthread_mutex_t *mutex);
  * Try to lock a mutex (non-blocking)
  * 
  * @param mutex Pointer to pthread_mutex_t to try lock
- * @return 0 if locked, 1 if already locked, -1 on failure
+ * @return 0 if locked, 1 if already locked, 2 if locked after its previous
+ *         owner died, -1 on failure
  */
 int sync_mutex_trylock(pthread_mutex_t *mutex);
 
@@ -130,7 +135,8 @@ int sync_cond_init(pthread_cond_t *cond);
  * 
  * @param cond Pointer to pthread_cond_t
  * @param mutex Pointer to associated pthread_mutex_t
- * @return 0 on success, -1 on failure
+ * @return 0 on success, 1 if the mutex was recovered from a dead owner,
+ *         -1 on failure
  */
 int sync_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex);
 
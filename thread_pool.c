@@ -0,0 +1,138 @@
+#define _GNU_SOURCE  // SCHED_IDLE
+#include "thread_pool.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+// Drop the calling thread to idle priority (Linux applies both per thread)
+static void lower_thread_priority(void) {
+    struct sched_param param = { .sched_priority = 0 };
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0) {
+        fprintf(stderr, "[POOL] Warning: SCHED_IDLE not available\n");
+    }
+    if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19) != 0) {
+        fprintf(stderr, "[POOL] Warning: failed to lower worker priority\n");
+    }
+}
+
+static void *worker_main(void *arg) {
+    ThreadPool *pool = (ThreadPool *)arg;
+
+    if (pool->low_priority) {
+        lower_thread_priority();
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (pool->count == 0 && !pool->shutting_down) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->count == 0 && pool->shutting_down) {
+            break;
+        }
+
+        PoolJob job = pool->queue[pool->head];
+        pool->head = (pool->head + 1) % POOL_QUEUE_SIZE;
+        pool->count--;
+        pool->busy++;
+        pthread_mutex_unlock(&pool->lock);
+
+        job.fn(job.arg);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->busy--;
+        if (pool->count == 0 && pool->busy == 0) {
+            pthread_cond_broadcast(&pool->all_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int pool_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+ThreadPool *pool_create(int num_threads, int low_priority) {
+    if (num_threads == 0) {
+        num_threads = pool_cpu_count();
+    }
+    if (num_threads < 1 || num_threads > POOL_MAX_THREADS) {
+        fprintf(stderr, "[POOL] Error: thread count must be 1-%d, got %d\n",
+                POOL_MAX_THREADS, num_threads);
+        return NULL;
+    }
+
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (pool == NULL) {
+        fprintf(stderr, "[POOL] Error: out of memory\n");
+        return NULL;
+    }
+
+    pool->low_priority = low_priority;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->all_done, NULL);
+
+    for (int i = 0; i < num_threads; i++) {
+        int result = pthread_create(&pool->threads[i], NULL, worker_main, pool);
+        if (result != 0) {
+            fprintf(stderr, "[POOL] Error: pthread_create failed: %s\n", strerror(result));
+            pool->num_threads = i;
+            pool_destroy(pool);
+            return NULL;
+        }
+    }
+    pool->num_threads = num_threads;
+    return pool;
+}
+
+int pool_submit(ThreadPool *pool, PoolTask fn, void *arg) {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->shutting_down || pool->count == POOL_QUEUE_SIZE) {
+        pthread_mutex_unlock(&pool->lock);
+        return -1;
+    }
+
+    int tail = (pool->head + pool->count) % POOL_QUEUE_SIZE;
+    pool->queue[tail].fn = fn;
+    pool->queue[tail].arg = arg;
+    pool->count++;
+
+    pthread_cond_signal(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+void pool_wait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->count > 0 || pool->busy > 0) {
+        pthread_cond_wait(&pool->all_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_destroy(ThreadPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutting_down = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->all_done);
+    free(pool);
+}
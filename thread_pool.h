@@ -0,0 +1,76 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+
+/**
+ * Thread Pool Module Header
+ *
+ * Fixed set of worker threads draining a bounded task queue.
+ * Used to fan simulation work (rollouts, fitness evaluation) out over
+ * several cores without paying pthread_create on every request.
+ *
+ * Pools are process-local: create them after fork(), never before.
+ */
+
+#define POOL_MAX_THREADS 64
+#define POOL_QUEUE_SIZE 256
+
+typedef void (*PoolTask)(void *arg);
+
+typedef struct {
+    PoolTask fn;
+    void *arg;
+} PoolJob;
+
+typedef struct {
+    pthread_t threads[POOL_MAX_THREADS];
+    int num_threads;
+
+    PoolJob queue[POOL_QUEUE_SIZE];
+    int head;
+    int count;
+    int busy;                    // Jobs currently executing
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;   // Signalled when a job is queued or on shutdown
+    pthread_cond_t all_done;     // Signalled when queue is empty and no job is running
+    int shutting_down;
+    int low_priority;            // Workers run at nice 19 under SCHED_IDLE
+} ThreadPool;
+
+/**
+ * Create a pool with num_threads workers
+ *
+ * Low-priority pools only get CPU time nobody else wants, so background
+ * analysis can never slow down the processes serving turns.
+ *
+ * @param num_threads Worker count (1 to POOL_MAX_THREADS); 0 means one per online CPU
+ * @param low_priority Non-zero to run workers at nice 19 under SCHED_IDLE
+ * @return Pool pointer, or NULL on failure
+ */
+ThreadPool *pool_create(int num_threads, int low_priority);
+
+/**
+ * Queue a task for execution
+ *
+ * @return 0 on success, -1 if the queue is full or the pool is shutting down
+ */
+int pool_submit(ThreadPool *pool, PoolTask fn, void *arg);
+
+/**
+ * Block until every queued task has finished
+ */
+void pool_wait(ThreadPool *pool);
+
+/**
+ * Finish queued work, join all workers and free the pool
+ */
+void pool_destroy(ThreadPool *pool);
+
+/**
+ * Number of online CPUs (at least 1)
+ */
+int pool_cpu_count(void);
+
+#endif // THREAD_POOL_H
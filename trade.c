@@ -0,0 +1,125 @@
+#include "trade.h"
+#include "sync.h"
+#include <string.h>
+
+static int is_alive(const GameState *state, int player_id) {
+    return player_id >= 0 && player_id < state->num_players && seat_is_alive(state, player_id);
+}
+
+// 1 if any tile in the list, or in its color group, has buildings on it
+static int any_built(const GameState *state, const BoardDef *board, const uint16_t tiles[]) {
+    for (int i = 0; i < TRADE_MAX_TILES && tiles[i] != TILE_NONE; i++) {
+        int t = tiles[i];
+        do {
+            if (state->buildings[t]) {
+                return 1;
+            }
+        } while ((t = board_group_next(board, t)) != tiles[i]);
+    }
+    return 0;
+}
+
+TradeStatus trade_check(const GameState *state, const BoardDef *board, const TradeOffer *offer) {
+    if (offer->from == offer->to || !is_alive(state, offer->from) || !is_alive(state, offer->to)) {
+        return TRADE_INVALID;
+    }
+    if (offer->give[0] == TILE_NONE && offer->take[0] == TILE_NONE && offer->cash == 0) {
+        return TRADE_INVALID;
+    }
+    // Each tile has one owner, so this also keeps the two lists apart
+    if (!owns_all(state, offer->from, offer->give, TRADE_MAX_TILES) ||
+        !owns_all(state, offer->to, offer->take, TRADE_MAX_TILES)) {
+        return TRADE_INVALID;
+    }
+    // Buildings must be sold before a group changes hands
+    if (any_built(state, board, offer->give) || any_built(state, board, offer->take)) {
+        return TRADE_INVALID;
+    }
+    // cash comes straight from the client: the payer must hold all of it,
+    // and the receiver's balance must still fit afterwards
+    int64_t cash = offer->cash;
+    int64_t from_money = state->players[offer->from].money;
+    int64_t to_money = state->players[offer->to].money;
+    if (offer->cash == INT32_MIN || (cash > 0 && cash > from_money) || (cash < 0 && -cash > to_money) ||
+        from_money - cash > INT32_MAX || to_money + cash > INT32_MAX) {
+        return TRADE_INVALID;
+    }
+    return TRADE_OK;
+}
+
+TradeStatus trade_propose(GameState *state, const BoardDef *board, TradeOffer *offer) {
+    TradeStatus status = trade_check(state, board, offer);
+    if (status != TRADE_OK) {
+        return status;
+    }
+
+    sync_mutex_lock(&state->trade_mutex);
+    SeatMask bit = seat_bit(offer->to);
+    if (state->trade_pending & bit) {
+        pthread_mutex_unlock(&state->trade_mutex);
+        return TRADE_BUSY;
+    }
+    offer->id = ++state->trade_seq;
+    offer->from_version = __atomic_load_n(&state->asset_version[offer->from], __ATOMIC_ACQUIRE);
+    offer->to_version = __atomic_load_n(&state->asset_version[offer->to], __ATOMIC_ACQUIRE);
+    state->trade_inbox[offer->to] = *offer;
+    __atomic_or_fetch(&state->trade_pending, bit, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&state->trade_mutex);
+    return TRADE_OK;
+}
+
+int trade_waiting(const GameState *state, int player_id) {
+    return (__atomic_load_n(&state->trade_pending, __ATOMIC_ACQUIRE) >> player_id) & 1;
+}
+
+int trade_take(GameState *state, int player_id, TradeOffer *offer) {
+    SeatMask bit = seat_bit(player_id);
+    sync_mutex_lock(&state->trade_mutex);
+    int taken = (state->trade_pending & bit) != 0;
+    if (taken) {
+        *offer = state->trade_inbox[player_id];
+        __atomic_and_fetch(&state->trade_pending, ~bit, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&state->trade_mutex);
+    return taken;
+}
+
+int trade_is_stale(const GameState *state, const TradeOffer *offer) {
+    return __atomic_load_n(&state->asset_version[offer->from], __ATOMIC_ACQUIRE) != offer->from_version ||
+           __atomic_load_n(&state->asset_version[offer->to], __ATOMIC_ACQUIRE) != offer->to_version;
+}
+
+TradeStatus trade_commit(GameState *state, const BoardDef *board, const TradeOffer *offer) {
+    if (trade_is_stale(state, offer)) {
+        return TRADE_STALE;
+    }
+    TradeStatus status = trade_check(state, board, offer);
+    if (status != TRADE_OK) {
+        return status;
+    }
+
+    state_write_begin(state);
+    int64_t cash = offer->cash;
+    state->players[offer->from].money = (int32_t)(state->players[offer->from].money - cash);
+    state->players[offer->to].money = (int32_t)(state->players[offer->to].money + cash);
+    for (int i = 0; i < TRADE_MAX_TILES && offer->give[i] != TILE_NONE; i++) {
+        set_property_owner(state, board, offer->give[i], offer->to);
+    }
+    for (int i = 0; i < TRADE_MAX_TILES && offer->take[i] != TILE_NONE; i++) {
+        set_property_owner(state, board, offer->take[i], offer->from);
+    }
+    state_write_end(state);
+    touch_assets(state, offer->from);
+    touch_assets(state, offer->to);
+    return TRADE_OK;
+}
+
+const char *trade_status_name(TradeStatus status) {
+    switch (status) {
+        case TRADE_OK: return "accepted";
+        case TRADE_STALE: return "stale";
+        case TRADE_INVALID: return "invalid";
+        case TRADE_BUSY: return "busy";
+    }
+    return "unknown";
+}
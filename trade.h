@@ -0,0 +1,56 @@
+#ifndef TRADE_H
+#define TRADE_H
+
+#include <stdint.h>
+#include "game_state.h"
+
+// Player-to-player trades of cash and tiles.
+// An offer records both players' asset_version[] when it is made. It waits
+// in the recipient's inbox (trade_mutex only) while they decide, so the
+// turn path never waits on a negotiation. Accepting re-checks the versions
+// without any lock first, then commits under a short game_mutex hold that
+// checks them again and moves everything in one step. Any change to either
+// side's cash or tiles in between makes the offer stale.
+
+#define TRADE_SECONDS 20        // How long a human recipient gets to answer
+#define TRADE_TAG 't'           // Client sends this byte, then a TradeOffer
+#define TRADE_REPLY_TAG '&'     // Client sends this byte, then a TradeReply
+
+typedef enum {
+    TRADE_OK,
+    TRADE_STALE,                // Either side's assets changed since the offer
+    TRADE_INVALID,              // Not owned, built on, unaffordable or not alive
+    TRADE_BUSY                  // Recipient already has an offer waiting
+} TradeStatus;
+
+// A client's answer to MSG_TRADE
+typedef struct {
+    uint32_t trade_id;
+    int32_t accept;             // 1 = accept, 0 = refuse
+} TradeReply;
+
+_Static_assert(sizeof(TradeReply) == sizeof(BidReply), "replies share one wire size");
+
+// Check an offer against the live state (caller holds game_mutex)
+TradeStatus trade_check(const GameState *state, const BoardDef *board, const TradeOffer *offer);
+
+// Stamp and validate an offer from `offer->from`, then leave it in the
+// recipient's inbox (caller holds game_mutex and wakes the recipient)
+TradeStatus trade_propose(GameState *state, const BoardDef *board, TradeOffer *offer);
+
+// 1 if an offer is waiting for player_id (lock-free hint)
+int trade_waiting(const GameState *state, int player_id);
+
+// Take the offer waiting for player_id. Returns 1, or 0 if there is none.
+int trade_take(GameState *state, int player_id, TradeOffer *offer);
+
+// 1 if either side's assets changed since the offer was made (no locks)
+int trade_is_stale(const GameState *state, const TradeOffer *offer);
+
+// Re-validate and apply an accepted offer atomically (caller holds game_mutex)
+TradeStatus trade_commit(GameState *state, const BoardDef *board, const TradeOffer *offer);
+
+// Short description for logs and replies
+const char *trade_status_name(TradeStatus status);
+
+#endif // TRADE_H
@@ -0,0 +1,57 @@
+#include "transposition.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TT_MAX_SIZE_LOG2 28
+
+int tt_init(TranspositionTable *tt, unsigned size_log2) {
+    if (tt == NULL || size_log2 == 0 || size_log2 > TT_MAX_SIZE_LOG2) {
+        fprintf(stderr, "[TT] Error: invalid table size 2^%u\n", size_log2);
+        return -1;
+    }
+
+    size_t count = (size_t)1 << size_log2;
+    tt->entries = aligned_alloc(64, count * sizeof(TTEntry));
+    if (tt->entries == NULL) {
+        fprintf(stderr, "[TT] Error: failed to allocate %zu entries\n", count);
+        return -1;
+    }
+
+    tt->mask = count - 1;
+    tt_clear(tt);
+    return 0;
+}
+
+void tt_free(TranspositionTable *tt) {
+    if (tt == NULL) {
+        return;
+    }
+    free(tt->entries);
+    tt->entries = NULL;
+    tt->mask = 0;
+}
+
+void tt_clear(TranspositionTable *tt) {
+    memset(tt->entries, 0, (tt->mask + 1) * sizeof(TTEntry));
+}
+
+int tt_probe(const TranspositionTable *tt, uint64_t key, uint64_t *data) {
+    const TTEntry *e = &tt->entries[key & tt->mask];
+    uint64_t check = __atomic_load_n(&e->check, __ATOMIC_RELAXED);
+    uint64_t value = __atomic_load_n(&e->data, __ATOMIC_RELAXED);
+
+    // Empty slots are all-zero, which only matches key 0 with data 0
+    if ((check ^ value) != key || (check == 0 && value == 0)) {
+        return 0;
+    }
+
+    *data = value;
+    return 1;
+}
+
+void tt_store(TranspositionTable *tt, uint64_t key, uint64_t data) {
+    TTEntry *e = &tt->entries[key & tt->mask];
+    __atomic_store_n(&e->check, key ^ data, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->data, data, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,50 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdint.h>
+
+// Fixed-size transposition table keyed by Zobrist hash.
+// Probes and stores are lock-free: each slot holds (key ^ data, data) written
+// with relaxed atomics, so a torn slot written by two threads at once simply
+// fails the key check on the next probe instead of returning garbage.
+// Replacement policy is always-replace.
+
+typedef struct {
+    uint64_t check;   // key ^ data
+    uint64_t data;
+} TTEntry;
+
+typedef struct {
+    TTEntry *entries;
+    uint64_t mask;    // num_entries - 1 (power of two)
+} TranspositionTable;
+
+// Pack/unpack the default payload: visit count and accumulated score
+static inline uint64_t tt_pack(uint32_t visits, int32_t score) {
+    return ((uint64_t)visits << 32) | (uint32_t)score;
+}
+
+static inline uint32_t tt_visits(uint64_t data) {
+    return (uint32_t)(data >> 32);
+}
+
+static inline int32_t tt_score(uint64_t data) {
+    return (int32_t)(uint32_t)data;
+}
+
+// Allocate 2^size_log2 entries. Returns 0 on success, -1 on failure
+int tt_init(TranspositionTable *tt, unsigned size_log2);
+
+// Release the table
+void tt_free(TranspositionTable *tt);
+
+// Forget every stored position
+void tt_clear(TranspositionTable *tt);
+
+// Look up a position. Returns 1 and fills *data on a hit, 0 on a miss
+int tt_probe(const TranspositionTable *tt, uint64_t key, uint64_t *data);
+
+// Store (or overwrite) the data for a position
+void tt_store(TranspositionTable *tt, uint64_t key, uint64_t data);
+
+#endif // TRANSPOSITION_H
@@ -0,0 +1,261 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "game_state.h"
+#include "simulation.h"
+#include "thread_pool.h"
+
+/**
+ * Bot policy tuner
+ *
+ * Evolves BotPolicy parameters (cash reserve and per-tile bias) with a
+ * (mu + lambda) evolution strategy. Every candidate plays the same set of
+ * seeded games (common random numbers) against the baseline policy, one
+ * seat at a time, and its fitness is the share of those games it won.
+ * Fitness evaluation is split into chunks and spread over a thread pool
+ * with one worker per core.
+ */
+
+#define DEFAULT_GENERATIONS 30
+#define DEFAULT_POPULATION 32
+#define DEFAULT_GAMES 2000
+#define DEFAULT_SEATS 4
+#define GAMES_PER_CHUNK 250
+#define MAX_POPULATION 256
+#define RESERVE_SIGMA 25.0
+#define BIAS_SIGMA 20.0
+#define BIAS_MUTATION_RATE 0.3
+#define MAX_RESERVE 500
+#define MAX_BIAS 200
+
+typedef struct {
+    BotPolicy policy;
+    double fitness;
+} Candidate;
+
+typedef struct {
+    const Candidate *candidate;
+    const BotPolicy *baseline;
+    const SimGame *start;
+    int seats;
+    unsigned int base_seed;
+    int first_game;
+    int num_games;
+    double score;            // Output: wins in this chunk
+} EvalChunk;
+
+static double gaussian(unsigned int *seed) {
+    double u1 = (rand_r(seed) + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand_r(seed) + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static int clamp(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void mutate(BotPolicy *policy, int tiles, unsigned int *seed) {
+    policy->cash_reserve = clamp(policy->cash_reserve + (int)lround(gaussian(seed) * RESERVE_SIGMA),
+                                 0, MAX_RESERVE);
+    for (int t = 0; t < tiles; t++) {
+        if (rand_r(seed) < RAND_MAX * BIAS_MUTATION_RATE) {
+            int bias = policy->tile_bias[t] + (int)lround(gaussian(seed) * BIAS_SIGMA);
+            policy->tile_bias[t] = (int16_t)clamp(bias, -MAX_BIAS, MAX_BIAS);
+        }
+    }
+}
+
+// Play a chunk of seeded games with the candidate rotating through the seats
+static void eval_chunk(void *arg) {
+    EvalChunk *chunk = (EvalChunk *)arg;
+    const BotPolicy *policies[PACKED_MAX_SEATS];
+    SimGame game;
+
+    sim_copy_board(&game, chunk->start);
+
+    chunk->score = 0.0;
+    for (int g = chunk->first_game; g < chunk->first_game + chunk->num_games; g++) {
+        int seat = g % chunk->seats;
+        for (int p = 0; p < chunk->seats; p++) {
+            policies[p] = (p == seat) ? &chunk->candidate->policy : chunk->baseline;
+        }
+
+        sim_reset(&game, &chunk->start->state);
+        game.seed = chunk->base_seed + (unsigned int)g * 2654435761u;
+        sim_redeal_cards(&game);
+        int winner = sim_playout(&game, policies, SIM_MAX_TURNS);
+
+        if (winner == seat) {
+            chunk->score += 1.0;
+        } else if (winner < 0 && packed_is_alive(&game.state, seat)) {
+            // Unfinished game: split the point between the survivors
+            int alive = __builtin_popcount(game.state.active_mask & ~game.state.bankrupt_mask);
+            chunk->score += 1.0 / alive;
+        }
+    }
+}
+
+static int compare_fitness(const void *a, const void *b) {
+    double fa = ((const Candidate *)a)->fitness;
+    double fb = ((const Candidate *)b)->fitness;
+    return (fa < fb) - (fa > fb);
+}
+
+static double elapsed_sec(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-g generations] [-p population] [-n games] [-s seats]\n"
+            "          [-t threads] [-S seed] [-o output] [-B board]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    int generations = DEFAULT_GENERATIONS;
+    int population = DEFAULT_POPULATION;
+    int games = DEFAULT_GAMES;
+    int seats = DEFAULT_SEATS;
+    int threads = 0;
+    unsigned int seed = (unsigned int)time(NULL);
+    const char *output = "bot_policy.txt";
+    const char *board_file = DEFAULT_BOARD_FILE;
+
+    int c;
+    while ((c = getopt(argc, argv, "g:p:n:s:t:S:o:B:")) != -1) {
+        switch (c) {
+            case 'g': generations = atoi(optarg); break;
+            case 'p': population = atoi(optarg); break;
+            case 'n': games = atoi(optarg); break;
+            case 's': seats = atoi(optarg); break;
+            case 't': threads = atoi(optarg); break;
+            case 'S': seed = (unsigned int)strtoul(optarg, NULL, 10); break;
+            case 'o': output = optarg; break;
+            case 'B': board_file = optarg; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    if (generations < 1 || population < 4 || population > MAX_POPULATION || games < 1 ||
+        seats < MIN_PLAYERS || seats > PACKED_MAX_SEATS) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const BoardDef *board = board_load(board_file);
+    if (board == NULL) {
+        return 1;
+    }
+
+    // Fresh table shared by every simulated game
+    static GameState table;
+    memset(&table, 0, sizeof(table));
+    init_board(&table, board);
+    init_decks(&table, seed);
+    table.game_state = PLAYING;
+    table.num_players = seats;
+    for (int i = 0; i < seats; i++) {
+        table.players[i].money = table.start_money;
+        seat_join(&table, i);
+    }
+
+    static SimGame start;
+    if (sim_init(&start, &table, board, seed) != 0) {
+        fprintf(stderr, "[TUNE] Error: table does not fit the packed limits\n");
+        return 1;
+    }
+
+    ThreadPool *pool = pool_create(threads, 0);
+    if (pool == NULL) {
+        return 1;
+    }
+
+    BotPolicy baseline;
+    bot_policy_default(&baseline);
+
+    Candidate *pop = calloc((size_t)population, sizeof(Candidate));
+    int chunks_per_candidate = (games + GAMES_PER_CHUNK - 1) / GAMES_PER_CHUNK;
+    EvalChunk *chunks = calloc((size_t)population * chunks_per_candidate, sizeof(EvalChunk));
+    if (pop == NULL || chunks == NULL) {
+        fprintf(stderr, "[TUNE] Error: out of memory\n");
+        pool_destroy(pool);
+        return 1;
+    }
+
+    // Generation 0: the baseline plus mutated copies of it
+    for (int i = 0; i < population; i++) {
+        pop[i].policy = baseline;
+        if (i > 0) {
+            mutate(&pop[i].policy, board->tile_count, &seed);
+        }
+    }
+
+    int elites = population / 4;
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    printf("[TUNE] %d generations x %d candidates x %d games on %d threads\n",
+           generations, population, games, pool->num_threads);
+
+    for (int gen = 0; gen < generations; gen++) {
+        unsigned int gen_seed = (unsigned int)rand_r(&seed);
+
+        // Elites are re-scored on the new seeds so luck does not carry over
+        int n = 0;
+        for (int i = 0; i < population; i++) {
+            for (int k = 0; k < chunks_per_candidate; k++, n++) {
+                EvalChunk *chunk = &chunks[n];
+                chunk->candidate = &pop[i];
+                chunk->baseline = &baseline;
+                chunk->start = &start;
+                chunk->seats = seats;
+                chunk->base_seed = gen_seed;
+                chunk->first_game = k * GAMES_PER_CHUNK;
+                chunk->num_games = (k == chunks_per_candidate - 1)
+                                       ? games - chunk->first_game : GAMES_PER_CHUNK;
+                while (pool_submit(pool, eval_chunk, chunk) != 0) {
+                    pool_wait(pool);   // Queue full: let workers drain it
+                }
+            }
+        }
+        pool_wait(pool);
+
+        for (int i = 0; i < population; i++) {
+            double wins = 0.0;
+            for (int k = 0; k < chunks_per_candidate; k++) {
+                wins += chunks[i * chunks_per_candidate + k].score;
+            }
+            pop[i].fitness = wins / games;
+        }
+        qsort(pop, (size_t)population, sizeof(Candidate), compare_fitness);
+
+        printf("[TUNE] gen %3d  best %.4f  median %.4f  reserve %d  (%.1fs)\n",
+               gen, pop[0].fitness, pop[population / 2].fitness,
+               pop[0].policy.cash_reserve, elapsed_sec(&start_time));
+        fflush(stdout);
+
+        // Replace everything below the elites with mutated elites
+        for (int i = elites; i < population; i++) {
+            pop[i].policy = pop[rand_r(&seed) % elites].policy;
+            mutate(&pop[i].policy, board->tile_count, &seed);
+        }
+    }
+
+    if (bot_policy_save(&pop[0].policy, output) != 0) {
+        fprintf(stderr, "[TUNE] Error: failed to write %s\n", output);
+    } else {
+        printf("[TUNE] Best policy (win rate %.4f vs baseline, fair share %.4f) saved to %s\n",
+               pop[0].fitness, 1.0 / seats, output);
+    }
+
+    free(chunks);
+    free(pop);
+    pool_destroy(pool);
+    board_close(board);
+    return 0;
+}
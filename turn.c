@@ -0,0 +1,116 @@
+#include "turn.h"
+#include "logger.h"
+
+// Roll for a player from the room's dice seed and resolve the landing
+LandingResult roll_turn(GameState *state, const TileDispatch *dispatch, int player_id, int *dice) {
+    state_write_begin(state);       // The roll advances the dice seed and may draw a card
+    *dice = roll_dice_seeded(&state->dice_seed);
+    int pos = (state->players[player_id].position + *dice) % state->board_size;
+    LandingResult landing = handle_landing_on_position(dispatch, pos, player_id,
+                                                       state->players[player_id].money,
+                                                       state->board_owner, state->tile_rent,
+                                                       state->decks);
+    state_write_end(state);
+    return landing;
+}
+
+// Take a player out of the game and return their tiles to the bank
+void declare_bankrupt(GameState *state, int player_id) {
+    state_write_begin(state);
+    state->players[player_id].is_bankrupt = 1;
+    state->alive_mask &= ~seat_bit(player_id);
+    int released = release_properties(state, player_id);
+    state_write_end(state);
+    logger_log("Player %d went bankrupt (%d properties returned to the bank)", player_id, released);
+}
+
+// Apply a landing result
+void commit_landing(GameState *state, const BoardDef *board, int player_id,
+                    const LandingResult *landing) {
+    int pos = landing->new_position;
+    state_write_begin(state);
+    state->players[player_id].position = pos;
+    state->players[player_id].money += landing->money_change;
+    if (landing->money_change != 0) {
+        touch_assets(state, player_id);
+    }
+    
+    // If property was bought, update owner
+    if (landing->property_bought) {
+        set_property_owner(state, board, pos, player_id);
+        logger_log("Player %d bought %s", player_id, board->tiles[pos].name);
+    }
+    
+    // If rent was paid, transfer to owner
+    if (landing->owner_id != -1 && landing->owner_id != player_id) {
+        state->players[landing->owner_id].money += (-landing->money_change);
+        touch_assets(state, landing->owner_id);
+        logger_log("Player %d paid $%d rent to Player %d", 
+                  player_id, -landing->money_change, landing->owner_id);
+    }
+    
+    // Card: every other player still in the game pays the drawer
+    if (landing->collect_amount > 0) {
+        for (SeatMask payers = state->alive_mask & ~seat_bit(player_id); payers; payers &= payers - 1) {
+            int i = __builtin_ctzll(payers);
+            Player *payer = &state->players[i];
+            payer->money -= landing->collect_amount;
+            state->players[player_id].money += landing->collect_amount;
+            touch_assets(state, i);
+            touch_assets(state, player_id);
+            logger_log("Player %d paid $%d to Player %d", i, landing->collect_amount, player_id);
+            if (is_player_bankrupt(payer->money)) {
+                declare_bankrupt(state, i);
+            }
+        }
+    }
+    
+    // Check bankruptcy
+    if (landing->is_bankrupt) {
+        declare_bankrupt(state, player_id);
+    }
+    state_write_end(state);
+}
+
+// Add one building level to the player's cheapest eligible tile
+int build_next_house(GameState *state, const BoardDef *board, int player_id) {
+    int tile = pick_build_tile(state, board, player_id);
+    if (tile < 0 || build_house(state, board, tile, player_id) != 0) {
+        return -1;
+    }
+    logger_log("Player %d built on %s (level %d, rent now $%d)", player_id,
+               board->tiles[tile].name, state->buildings[tile], state->tile_rent[tile]);
+    return tile;
+}
+
+// Seats that may bid in an auction (every player still in)
+SeatMask auction_bidders(const GameState *state) {
+    return state->alive_mask;
+}
+
+// Close the room's auction and hand the tile to the highest bidder
+int settle_auction(GameState *state, const BoardDef *board, int *price) {
+    int tile = state->auction.tile;
+    int winner = auction_close(&state->auction, price);
+    
+    // Bids were checked against cash when posted; rent, cards or trades
+    // since then may have left the bidder short or out of the game. Their
+    // bid is struck and the next highest stands.
+    while (winner >= 0 && (!seat_is_alive(state, winner) || state->players[winner].money < *price)) {
+        logger_log("Auction of %s: Player %d can no longer pay $%d", board->tiles[tile].name,
+                   winner, *price);
+        auction_drop_bid(&state->auction, winner);
+        winner = auction_best_bid(&state->auction, price);
+    }
+    if (winner < 0) {
+        logger_log("Auction of %s: no bids", board->tiles[tile].name);
+        return -1;
+    }
+    state_write_begin(state);
+    state->players[winner].money -= *price;
+    set_property_owner(state, board, tile, winner);
+    state_write_end(state);
+    logger_log("Auction of %s won by Player %d for $%d (%d bids)", board->tiles[tile].name, winner,
+               *price, seat_count(state->auction.answered));
+    return winner;
+}
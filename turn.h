@@ -0,0 +1,33 @@
+#ifndef TURN_H
+#define TURN_H
+
+#include "game_state.h"
+#include "game_logic.h"
+
+// Applying a turn's outcome to a room. Shared by the server (on shared
+// memory, caller holds game_mutex) and the replayer (on a private copy),
+// so a recorded game replays through exactly the rules that served it.
+
+// Roll for a player from the room's dice seed and resolve the landing
+// without committing it
+LandingResult roll_turn(GameState *state, const TileDispatch *dispatch, int player_id, int *dice);
+
+// Apply a landing result (rent, purchases, cards, bankruptcies)
+void commit_landing(GameState *state, const BoardDef *board, int player_id,
+                    const LandingResult *landing);
+
+// Take a player out of the game and return their tiles to the bank
+void declare_bankrupt(GameState *state, int player_id);
+
+// Add one building level to the player's cheapest eligible tile.
+// Returns the tile, or -1 if nothing can be built.
+int build_next_house(GameState *state, const BoardDef *board, int player_id);
+
+// Seats that may bid in an auction (every player still in)
+SeatMask auction_bidders(const GameState *state);
+
+// Close the room's auction and hand the tile to the highest bidder who can
+// still pay. Returns the winner (price in *price), or -1 if nobody can.
+int settle_auction(GameState *state, const BoardDef *board, int *price);
+
+#endif // TURN_H
@@ -0,0 +1,170 @@
+#include "zobrist.h"
+#include <pthread.h>
+#include <string.h>
+
+#define ZOBRIST_SEED 0x4d6f6e6f706f6c79ULL  // "Monopoly"
+
+static uint64_t position_keys[PACKED_MAX_SEATS][PACKED_MAX_TILES];
+static uint64_t owner_keys[PACKED_MAX_TILES][PACKED_MAX_SEATS];
+static uint64_t building_keys[PACKED_MAX_TILES][BOARD_RENT_LEVELS];
+static uint64_t money_keys[PACKED_MAX_SEATS][ZOBRIST_MONEY_BUCKETS];
+static uint64_t alive_keys[PACKED_MAX_SEATS];
+static uint64_t turn_keys[PACKED_MAX_SEATS];
+static pthread_once_t keys_once = PTHREAD_ONCE_INIT;
+
+// splitmix64: small, fast generator with well-mixed 64-bit output
+static uint64_t next_key(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void init_keys(void) {
+    uint64_t state = ZOBRIST_SEED;
+
+    for (int p = 0; p < PACKED_MAX_SEATS; p++) {
+        for (int t = 0; t < PACKED_MAX_TILES; t++) {
+            position_keys[p][t] = next_key(&state);
+        }
+        for (int b = 0; b < ZOBRIST_MONEY_BUCKETS; b++) {
+            money_keys[p][b] = next_key(&state);
+        }
+        alive_keys[p] = next_key(&state);
+        turn_keys[p] = next_key(&state);
+    }
+
+    // Unowned tiles contribute nothing, so only owned tiles need keys
+    for (int t = 0; t < PACKED_MAX_TILES; t++) {
+        for (int p = 0; p < PACKED_MAX_SEATS; p++) {
+            owner_keys[t][p] = next_key(&state);
+        }
+    }
+    
+    // Unbuilt tiles contribute nothing either; drawn last so the keys above keep their values
+    for (int t = 0; t < PACKED_MAX_TILES; t++) {
+        for (int l = 1; l < BOARD_RENT_LEVELS; l++) {
+            building_keys[t][l] = next_key(&state);
+        }
+    }
+}
+
+static inline void ensure_keys(void) {
+    pthread_once(&keys_once, init_keys);
+}
+
+static inline int money_bucket(int money) {
+    if (money < 0) {
+        return 0;
+    }
+    int bucket = money / ZOBRIST_MONEY_STEP + 1;
+    return bucket < ZOBRIST_MONEY_BUCKETS ? bucket : ZOBRIST_MONEY_BUCKETS - 1;
+}
+
+static inline uint64_t owner_key(int tile, int owner) {
+    return owner < 0 ? 0 : owner_keys[tile][owner];
+}
+
+uint64_t zobrist_hash(const PackedGameState *s) {
+    ensure_keys();
+
+    uint64_t hash = 0;
+    for (int p = 0; p < s->num_players; p++) {
+        hash ^= position_keys[p][packed_get_position(s, p)];
+        hash ^= money_keys[p][money_bucket(s->money[p])];
+        if (packed_is_alive(s, p)) {
+            hash ^= alive_keys[p];
+        }
+    }
+
+    for (int t = 0; t < s->board_size; t++) {
+        hash ^= owner_key(t, packed_get_owner(s, t));
+        hash ^= building_keys[t][s->buildings[t]];
+    }
+
+    hash ^= turn_keys[s->current_turn];
+    return hash;
+}
+
+uint64_t zobrist_move(uint64_t hash, int seat, int from, int to) {
+    ensure_keys();
+    return hash ^ position_keys[seat][from] ^ position_keys[seat][to];
+}
+
+uint64_t zobrist_owner(uint64_t hash, int tile, int old_owner, int new_owner) {
+    ensure_keys();
+    return hash ^ owner_key(tile, old_owner) ^ owner_key(tile, new_owner);
+}
+
+uint64_t zobrist_building(uint64_t hash, int tile, int old_level, int new_level) {
+    ensure_keys();
+    return hash ^ building_keys[tile][old_level] ^ building_keys[tile][new_level];
+}
+
+uint64_t zobrist_money(uint64_t hash, int seat, int old_money, int new_money) {
+    ensure_keys();
+    int old_bucket = money_bucket(old_money);
+    int new_bucket = money_bucket(new_money);
+    if (old_bucket == new_bucket) {
+        return hash;
+    }
+    return hash ^ money_keys[seat][old_bucket] ^ money_keys[seat][new_bucket];
+}
+
+uint64_t zobrist_alive(uint64_t hash, int seat) {
+    ensure_keys();
+    return hash ^ alive_keys[seat];
+}
+
+uint64_t zobrist_turn(uint64_t hash, int old_turn, int new_turn) {
+    ensure_keys();
+    return hash ^ turn_keys[old_turn] ^ turn_keys[new_turn];
+}
+
+uint64_t zobrist_apply_landing(PackedGameState *s, uint64_t hash, int player_id,
+                               const LandingResult *landing) {
+    int new_position = landing->new_position;
+    int old_position = packed_get_position(s, player_id);
+    int32_t old_money[PACKED_MAX_SEATS];
+    uint64_t old_owned[PACKED_MAX_SEATS];
+    uint8_t old_buildings[PACKED_MAX_TILES];
+    uint8_t old_alive = s->active_mask & ~s->bankrupt_mask;
+    memcpy(old_money, s->money, sizeof(old_money));
+    memcpy(old_owned, s->owned, sizeof(old_owned));
+    memcpy(old_buildings, s->buildings, sizeof(old_buildings));
+
+    packed_apply_landing(s, player_id, landing);
+
+    hash = zobrist_move(hash, player_id, old_position, new_position);
+
+    // A purchase changes one tile, a bankruptcy releases a whole portfolio
+    // (and demolishes its buildings)
+    uint64_t changed = 0;
+    for (int p = 0; p < s->num_players; p++) {
+        changed |= old_owned[p] ^ s->owned[p];
+    }
+    while (changed) {
+        int tile = __builtin_ctzll(changed);
+        changed &= changed - 1;
+        int old_owner = -1;
+        for (int p = 0; p < s->num_players; p++) {
+            if ((old_owned[p] >> tile) & 1) {
+                old_owner = p;
+            }
+        }
+        hash = zobrist_owner(hash, tile, old_owner, packed_get_owner(s, tile));
+        hash = zobrist_building(hash, tile, old_buildings[tile], s->buildings[tile]);
+    }
+
+    // Rent and collect-from-all cards can touch any seat's money
+    uint8_t alive = s->active_mask & ~s->bankrupt_mask;
+    for (int p = 0; p < s->num_players; p++) {
+        if (s->money[p] != old_money[p]) {
+            hash = zobrist_money(hash, p, old_money[p], s->money[p]);
+        }
+        if (((alive ^ old_alive) >> p) & 1) {
+            hash = zobrist_alive(hash, p);
+        }
+    }
+    return hash;
+}
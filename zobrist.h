@@ -0,0 +1,32 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+#include "packed_state.h"
+#include "game_logic.h"
+
+// Zobrist hashing of a packed game position: seat positions, tile owners,
+// building levels, bucketed money, alive seats and whose turn it is. Keys are generated once
+// per process from a fixed seed, so hashes agree across processes.
+// Card deck order is hidden information and is deliberately not hashed.
+
+#define ZOBRIST_MONEY_STEP 50      // Width of one money bucket in $
+#define ZOBRIST_MONEY_BUCKETS 32   // Bucket 0 = in debt, last bucket is open-ended
+
+// Full hash of a position (use when seeding a search)
+uint64_t zobrist_hash(const PackedGameState *s);
+
+// Incremental updates: XOR out the old feature, XOR in the new one
+uint64_t zobrist_move(uint64_t hash, int seat, int from, int to);
+uint64_t zobrist_owner(uint64_t hash, int tile, int old_owner, int new_owner);
+uint64_t zobrist_building(uint64_t hash, int tile, int old_level, int new_level);
+uint64_t zobrist_money(uint64_t hash, int seat, int old_money, int new_money);
+uint64_t zobrist_alive(uint64_t hash, int seat);
+uint64_t zobrist_turn(uint64_t hash, int old_turn, int new_turn);
+
+// Apply a landing result to s (see packed_apply_landing) and return the
+// updated hash without rehashing the whole position
+uint64_t zobrist_apply_landing(PackedGameState *s, uint64_t hash, int player_id,
+                               const LandingResult *landing);
+
+#endif // ZOBRIST_H